@@ -1,4 +1,5 @@
 #include "BMP280.h"
+#include "unit/barometric_altitude.hpp"
 
 bool BMP280::begin(TwoWire* wire, uint8_t addr, uint8_t sda, uint8_t scl,
                    long freq) {
@@ -12,19 +13,70 @@ bool BMP280::begin(TwoWire* wire, uint8_t addr, uint8_t sda, uint8_t scl,
 
     return true;
 }
+/*!
+ * @brief Reads pressure and temperature, and fills altitude for the standard
+ * sea level pressure.
+ * @return true if successful
+ * @note altitude is a table lookup (no pow), see getAltitude()
+ */
 bool BMP280::update() {
-    readTemperature();
-    readPressure();
-    readAltitude();
+    if (!updateBurst()) {
+        return false;
+    }
+    getAltitude();
+    return true;
+}
 
+/*!
+ * @brief Reads pressure and temperature in one burst (0xF7 - 0xFC) and
+ * compensates them once.
+ * @return true if successful
+ * @note altitude is not updated, use getAltitude() when it is needed
+ */
+bool BMP280::updateBurst() {
+    uint8_t buffer[6];
+    if (!_i2c.readBytes(_addr, BMP280_REGISTER_PRESSUREDATA, buffer, 6)) {
+        return false;
+    }
+    int32_t adc_P = (uint32_t(buffer[0]) << 12) | (uint32_t(buffer[1]) << 4) |
+                    (buffer[2] >> 4);
+    int32_t adc_T = (uint32_t(buffer[3]) << 12) | (uint32_t(buffer[4]) << 4) |
+                    (buffer[5] >> 4);
+
+    // Temperature first to get the t_fine variable set up
+    compensateTemperature(adc_T);
+    compensatePressure(adc_P);
+    _altitudeValid = false;
     return true;
 }
 
-float BMP280::readTemperature() {
-    int32_t var1, var2;
+/*!
+ * @brief Altitude from the latest pressure, calculated only when the pressure
+ * or the reference has changed since the last call.
+ * @param seaLevelhPa
+ *        The current hPa at sea level.
+ * @return The approximate altitude above sea level in meters.
+ * @note Same international barometric formula as before, interpolated
+ * without pow by m5::unit::barometric::altitude (within 0.25 m, pressures
+ * are clamped to 300 - 1100 hPa)
+ */
+float BMP280::getAltitude(float seaLevelhPa) {
+    if (!_altitudeValid || _altitudeSeaLevel != seaLevelhPa) {
+        altitude = m5::unit::barometric::altitude(pressure,
+                                                  seaLevelhPa * 100.0f);
+        _altitudeSeaLevel = seaLevelhPa;
+        _altitudeValid    = true;
+    }
+    return altitude;
+}
 
+float BMP280::readTemperature() {
     int32_t adc_T = read24(BMP280_REGISTER_TEMPDATA);
-    adc_T >>= 4;
+    return compensateTemperature(adc_T >> 4);
+}
+
+float BMP280::compensateTemperature(int32_t adc_T) {
+    int32_t var1, var2;
 
     var1 = ((((adc_T >> 3) - ((int32_t)_bmp280_calib.dig_T1 << 1))) *
             ((int32_t)_bmp280_calib.dig_T2)) >>
@@ -44,12 +96,14 @@ float BMP280::readTemperature() {
 }
 
 float BMP280::readPressure() {
-    int64_t var1, var2, p;
-
     // Must be done first to get the t_fine variable set up
 
     int32_t adc_P = read24(BMP280_REGISTER_PRESSUREDATA);
-    adc_P >>= 4;
+    return compensatePressure(adc_P >> 4);
+}
+
+float BMP280::compensatePressure(int32_t adc_P) {
+    int64_t var1, var2, p;
 
     var1 = ((int64_t)t_fine) - 128000;
     var2 = var1 * var1 * (int64_t)_bmp280_calib.dig_P6;
@@ -69,7 +123,8 @@ float BMP280::readPressure() {
     var2 = (((int64_t)_bmp280_calib.dig_P8) * p) >> 19;
 
     p = ((p + var1 + var2) >> 8) + (((int64_t)_bmp280_calib.dig_P7) << 4);
-    pressure = p / 256;
+    pressure       = p / 256;
+    _altitudeValid = false;
     return pressure;
 }
 
@@ -81,10 +136,8 @@ float BMP280::readPressure() {
  * @return The approximate altitude above sea level in meters.
  */
 float BMP280::readAltitude(float seaLevelhPa) {
-    float pressure = readPressure();  // in Si units for Pascal
-    pressure /= 100;
-    altitude = 44330 * (1.0 - pow(pressure / seaLevelhPa, 0.1903));
-    return altitude;
+    readPressure();  // in Si units for Pascal
+    return getAltitude(seaLevelhPa);
 }
 
 void BMP280::setSampling(sensor_mode mode, sensor_sampling tempSampling,
@@ -131,7 +184,10 @@ float BMP280::seaLevelForAltitude(float altitude, float atmospheric) {
     // Note that using the equation from wikipedia can give bad results
     // at high altitude.  See this thread for more information:
     // http://forums.adafruit.com/viewtopic.php?f=22&t=58064
-    return atmospheric / pow(1.0 - (altitude / 44330.0), 5.255);
+
+    // Same formula interpolated without pow (altitude is clamped to -1000 -
+    // 9500 m)
+    return m5::unit::barometric::sea_level_pressure(atmospheric, altitude);
 }
 
 /*!
@@ -116,6 +116,8 @@ class BMP280 {
     bool begin(TwoWire *wire = &Wire, uint8_t addr = BMP280_I2C_ADDR,
                uint8_t sda = 21, uint8_t scl = 22, long freq = 400000U);
     bool update();
+    bool updateBurst();
+    float getAltitude(float seaLevelhPa = 1013.25);
 
     float pressure = 0;
     float cTemp    = 0;
@@ -177,6 +179,8 @@ class BMP280 {
     };
 
     void readCoefficients(void);
+    float compensateTemperature(int32_t adc_T);
+    float compensatePressure(int32_t adc_P);
     uint8_t spixfer(uint8_t x);
     void write8(byte reg, byte value);
     uint8_t read8(byte reg);
@@ -187,6 +191,8 @@ class BMP280 {
     int16_t readS16_LE(byte reg);
 
     int32_t t_fine;
+    bool _altitudeValid     = false;
+    float _altitudeSeaLevel = 0;
     bmp280_calib_data _bmp280_calib;
     config _configReg;
     ctrl_meas _measReg;
@@ -32,6 +32,18 @@
 #include "unit/unit_SHT40.hpp"
 #include "unit/unit_BMP280.hpp"
 #include "unit/unit_ENV4.hpp"
+// Compensation between units
+#include "unit/scd4x_pressure_compensator.hpp"
+#include "unit/sgp30_humidity_compensator.hpp"
+// Persistence
+#include "unit/sgp30_baseline_manager.hpp"
+#include "unit/bme688_state_manager.hpp"
+// Estimation
+#include "unit/bme688_iaq_estimator.hpp"
+#include "unit/barometric_altitude.hpp"
+// Streaming
+#include "unit/stream_encoder.hpp"
+#include "unit/text_fields.hpp"
 
 /*!
   @namespace m5
@@ -23,6 +23,38 @@
 
 #include "SCD4X.h"
 
+namespace {
+// CRC-8 (polynomial 0x31) of every byte value
+const uint8_t crc8_table[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA,
+    0x7D, 0x4C, 0x1F, 0x2E, 0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4,
+    0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D, 0x86, 0xB7, 0xE4, 0xD5,
+    0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F,
+    0xB8, 0x89, 0xDA, 0xEB, 0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA,
+    0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13, 0x7E, 0x4F, 0x1C, 0x2D,
+    0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51,
+    0xC6, 0xF7, 0xA4, 0x95, 0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F,
+    0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6, 0x7A, 0x4B, 0x18, 0x29,
+    0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3,
+    0x44, 0x75, 0x26, 0x17, 0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B,
+    0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2, 0xBF, 0x8E, 0xDD, 0xEC,
+    0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD,
+    0x3A, 0x0B, 0x58, 0x69, 0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93,
+    0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A, 0xC1, 0xF0, 0xA3, 0x92,
+    0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68,
+    0xFF, 0xCE, 0x9D, 0xAC,
+};
+
+uint8_t crc8_word(const uint8_t *data) {
+    return crc8_table[crc8_table[0xFF ^ data[0]] ^ data[1]];
+}
+}  // namespace
+
 SCD4X::SCD4X(scd4x_sensor_type_e sensorType) {
     // Constructor
     _sensorType = sensorType;
@@ -86,7 +118,10 @@ bool SCD4X::startPeriodicMeasurement(void) {
     }
 
     bool success = sendCommand(SCD4x_COMMAND_START_PERIODIC_MEASUREMENT);
-    if (success) periodicMeasurementsAreRunning = true;
+    if (success) {
+        periodicMeasurementsAreRunning = true;
+        _measurementInterval           = SCD4x_PERIODIC_INTERVAL_MS;
+    }
     return (success);
 }
 
@@ -135,13 +170,6 @@ bool SCD4X::readMeasurement(void) {
     // Verify we have data from the sensor
     if (getDataReadyStatus() == false) return (false);
 
-    scd4x_unsigned16Bytes_t tempCO2;
-    tempCO2.unsigned16 = 0;
-    scd4x_unsigned16Bytes_t tempHumidity;
-    tempHumidity.unsigned16 = 0;
-    scd4x_unsigned16Bytes_t tempTemperature;
-    tempTemperature.unsigned16 = 0;
-
     _wire->beginTransmission(_addr);
     _wire->write(SCD4x_COMMAND_READ_MEASUREMENT >> 8);    // MSB
     _wire->write(SCD4x_COMMAND_READ_MEASUREMENT & 0xFF);  // LSB
@@ -149,65 +177,30 @@ bool SCD4X::readMeasurement(void) {
 
     delay(1);  // Datasheet specifies this
 
-    _wire->requestFrom((uint8_t)_addr, (uint8_t)9);
-    bool error = false;
-    if (_wire->available()) {
-        byte bytesToCrc[2];
-        for (byte x = 0; x < 9; x++) {
-            byte incoming = _wire->read();
-
-            switch (x) {
-                case 0:
-                case 1:
-                    tempCO2.bytes[x == 0 ? 1 : 0] =
-                        incoming;  // Store the two CO2 bytes in
-                                   // little-endian format
-                    bytesToCrc[x] =
-                        incoming;  // Calculate the CRC on the two CO2 bytes
-                                   // in the order they arrive
-                    break;
-                case 3:
-                case 4:
-                    tempTemperature.bytes[x == 3 ? 1 : 0] =
-                        incoming;  // Store the two T bytes in little-endian
-                                   // format
-                    bytesToCrc[x % 3] =
-                        incoming;  // Calculate the CRC on the two T bytes
-                                   // in the order they arrive
-                    break;
-                case 6:
-                case 7:
-                    tempHumidity.bytes[x == 6 ? 1 : 0] =
-                        incoming;  // Store the two RH bytes in
-                                   // little-endian format
-                    bytesToCrc[x % 3] =
-                        incoming;  // Calculate the CRC on the two RH bytes
-                                   // in the order they arrive
-                    break;
-                default:  // x == 2, 5, 8
-                    // Validate CRC
-                    uint8_t foundCrc = computeCRC8(
-                        bytesToCrc, 2);  // Calculate what the CRC should be
-                                         // for these two bytes
-                    if (foundCrc != incoming)  // Does this match the CRC
-                                               // byte from the sensor?
-                    {
-                        error = true;
-                    }
-                    break;
-            }
-        }
-    } else {
-        return (false);
+    // CO2, T and RH words, each followed by its CRC
+    uint8_t frame[9];
+    if (_wire->requestFrom((uint8_t)_addr, (uint8_t)9) != 9) return (false);
+    for (byte x = 0; x < 9; x++) {
+        frame[x] = _wire->read();
     }
-
-    if (error) {
-        return (false);
+    for (byte x = 0; x < 9; x += 3) {
+        if (crc8_word(frame + x) != frame[x + 2]) return (false);
     }
+
+    uint16_t rawCO2         = ((uint16_t)frame[0] << 8) | frame[1];
+    uint16_t rawTemperature = ((uint16_t)frame[3] << 8) | frame[4];
+    uint16_t rawHumidity    = ((uint16_t)frame[6] << 8) | frame[7];
+
     // Now copy the int16s into their associated floats
-    co2         = (float)tempCO2.unsigned16;
-    temperature = -45 + (((float)tempTemperature.unsigned16) * 175 / 65536);
-    humidity    = ((float)tempHumidity.unsigned16) * 100 / 65536;
+    co2         = (float)rawCO2;
+    temperature = -45 + (((float)rawTemperature) * 175 / 65536);
+    humidity    = ((float)rawHumidity) * 100 / 65536;
+
+    _snapshot.co2         = rawCO2;
+    _snapshot.temperature = temperature;
+    _snapshot.humidity    = humidity;
+    _snapshot.timestamp   = millis();
+    if (_snapshot.timestamp == 0) _snapshot.timestamp = 1;
 
     // Mark our global variables as fresh
     co2HasBeenReported         = false;
@@ -217,40 +210,39 @@ bool SCD4X::readMeasurement(void) {
     return (true);  // Success! New data available in globals.
 }
 
-// Returns the latest available CO2 level
-// If the current level has already been reported, trigger a new read
-uint16_t SCD4X::getCO2(void) {
-    if (co2HasBeenReported == true)  // Trigger a new read
-        readMeasurement();           // Pull in new co2, humidity, and temp into
-                                     // global vars
+// Read a new frame only once the signal update interval has passed since the
+// last one, so that repeated calls cost no I2C traffic in between
+bool SCD4X::updateSnapshot(void) {
+    if (periodicMeasurementsAreRunning && _snapshot.timestamp != 0 &&
+        millis() - _snapshot.timestamp < _measurementInterval) {
+        return (false);
+    }
+    return readMeasurement();
+}
 
+// Returns the CO2 level of the latest frame
+// If the current frame has already been reported, update the snapshot, which
+// reads the sensor at most once per signal update interval
+uint16_t SCD4X::getCO2(void) {
+    if (co2HasBeenReported == true) updateSnapshot();
     co2HasBeenReported = true;
-
-    return (uint16_t)co2;  // Cut off decimal as co2 is 0 to 10,000
+    return _snapshot.co2;
 }
 
-// Returns the latest available humidity
-// If the current level has already been reported, trigger a new read
+// Returns the humidity of the latest frame
+// If the current frame has already been reported, update the snapshot
 float SCD4X::getHumidity(void) {
-    if (humidityHasBeenReported == true)  // Trigger a new read
-        readMeasurement();  // Pull in new co2, humidity, and temp into
-                            // global vars
-
+    if (humidityHasBeenReported == true) updateSnapshot();
     humidityHasBeenReported = true;
-
-    return humidity;
+    return _snapshot.humidity;
 }
 
-// Returns the latest available temperature
-// If the current level has already been reported, trigger a new read
+// Returns the temperature of the latest frame
+// If the current frame has already been reported, update the snapshot
 float SCD4X::getTemperature(void) {
-    if (temperatureHasBeenReported == true)  // Trigger a new read
-        readMeasurement();  // Pull in new co2, humidity, and temp into
-                            // global vars
-
+    if (temperatureHasBeenReported == true) updateSnapshot();
     temperatureHasBeenReported = true;
-
-    return temperature;
+    return _snapshot.temperature;
 }
 
 // Set the temperature offset (C). See 3.6.1
@@ -488,7 +480,10 @@ bool SCD4X::startLowPowerPeriodicMeasurement(void) {
 
     bool success =
         sendCommand(SCD4x_COMMAND_START_LOW_POWER_PERIODIC_MEASUREMENT);
-    if (success) periodicMeasurementsAreRunning = true;
+    if (success) {
+        periodicMeasurementsAreRunning = true;
+        _measurementInterval = SCD4x_LOW_POWER_PERIODIC_INTERVAL_MS;
+    }
     return (success);
 }
 
@@ -779,14 +774,7 @@ uint8_t SCD4X::computeCRC8(uint8_t data[], uint8_t len) {
     uint8_t crc = 0xFF;  // Init with 0xFF
 
     for (uint8_t x = 0; x < len; x++) {
-        crc ^= data[x];  // XOR-in the next input byte
-
-        for (uint8_t i = 0; i < 8; i++) {
-            if ((crc & 0x80) != 0)
-                crc = (uint8_t)((crc << 1) ^ 0x31);
-            else
-                crc <<= 1;
-        }
+        crc = crc8_table[crc ^ data[x]];  // One table lookup per byte
     }
 
     return crc;  // No output reflection
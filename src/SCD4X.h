@@ -92,6 +92,18 @@ typedef union {
     uint8_t bytes[2];
 } scd4x_unsigned16Bytes_t;  // Make it easy to convert 2 x uint8_t to uint16_t
 
+// Immutable copy of one measurement frame
+typedef struct {
+    uint16_t co2;        // CO2 (ppm)
+    float temperature;   // Temperature (Celsius)
+    float humidity;      // Relative humidity (%RH)
+    uint32_t timestamp;  // millis() when the frame was read, 0 if never read
+} scd4x_sample_t;
+
+// Signal update intervals (ms)
+#define SCD4x_PERIODIC_INTERVAL_MS           5000
+#define SCD4x_LOW_POWER_PERIODIC_INTERVAL_MS 30000
+
 typedef enum {
     SCD4x_SENSOR_SCD40 = 0,
     SCD4x_SENSOR_SCD41,
@@ -132,12 +144,21 @@ class SCD4X {
     bool readMeasurement(void);  // Check for fresh data; store it. Returns true
                                  // if fresh data is available
 
-    uint16_t getCO2(void);    // Return the CO2 PPM. Automatically request fresh
-                              // data is the data is 'stale'
-    float getHumidity(void);  // Return the RH. Automatically request fresh data
-                              // is the data is 'stale'
-    float getTemperature(void);  // Return the temperature. Automatically
-                                 // request fresh data is the data is 'stale'
+    // Snapshot API: reads the sensor at most once per signal update interval
+    // and serves every value from the same frame
+    bool updateSnapshot(void);  // Returns true if a new frame is read
+    const scd4x_sample_t &getSnapshot(void) const {
+        return _snapshot;
+    }
+
+    // The getters are served from the snapshot. If the value is 'stale' the
+    // snapshot is updated, so the sensor is read at most once per interval.
+    // Repeated calls within the interval (5 s, or 30 s in low power periodic)
+    // return the same frame, earlier versions read the sensor on every stale
+    // call
+    uint16_t getCO2(void);       // Return the CO2 PPM
+    float getHumidity(void);     // Return the RH
+    float getTemperature(void);  // Return the temperature
 
     // Define how warm the sensor is compared to ambient, so RH and T are
     // temperature compensated. Has no effect on the CO2 reading Default offset
@@ -226,6 +247,10 @@ class SCD4X {
     // Keep track of whether periodic measurements are in progress
     bool periodicMeasurementsAreRunning = false;
 
+    // Latest frame and the signal update interval of the running mode
+    scd4x_sample_t _snapshot       = {};
+    uint32_t _measurementInterval = SCD4x_PERIODIC_INTERVAL_MS;
+
     // Convert serial number digit to ASCII
     char convertHexToASCII(uint8_t digit);
 };
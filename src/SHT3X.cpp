@@ -9,20 +9,41 @@ bool SHT3X::begin(TwoWire* wire, uint8_t addr, uint8_t sda, uint8_t scl,
 }
 
 bool SHT3X::update() {
-    unsigned int data[6];
+    if (!trigger()) return false;
+    delay(SHT3X_MEASURE_DURATION_MS);
+    while (busy()) {
+        if (poll()) return true;
+        delay(1);
+    }
+    return false;
+}
 
+bool SHT3X::trigger() {
     // Start I2C Transmission
     _wire->beginTransmission(_addr);
-    // Send measurement command
-    _wire->write(0x2C);
-    _wire->write(0x06);
+    // Send measurement command (high repeatability, no clock stretching)
+    // The sensor NACKs the read header until the measurement is done
+    _wire->write(0x24);
+    _wire->write(0x00);
     // Stop I2C transmission
-    if (_wire->endTransmission() != 0) return false;
+    _pending = (_wire->endTransmission() == 0);
+    _readyAt = millis() + SHT3X_MEASURE_DURATION_MS;
+    return _pending;
+}
 
-    delay(200);
+bool SHT3X::poll() {
+    if (!_pending || (int32_t)(millis() - _readyAt) < 0) return false;
+
+    uint8_t data[6];
 
     // Request 6 bytes of data
-    _wire->requestFrom(_addr, (uint8_t)6);
+    if (_wire->requestFrom(_addr, (uint8_t)6) != 6) {
+        if ((int32_t)(millis() - _readyAt) > SHT3X_POLL_TIMEOUT_MS) {
+            _pending = false;
+        }
+        return false;
+    }
+    _pending = false;
 
     // Read 6 bytes of data
     // cTemp msb, cTemp lsb, cTemp crc, humidity msb, humidity lsb, humidity crc
@@ -30,9 +51,9 @@ bool SHT3X::update() {
         data[i] = _wire->read();
     };
 
-    delay(50);
-
-    if (_wire->available() != 0) return false;
+    if (data[2] != crc8(data, 2) || data[5] != crc8(data + 3, 2)) {
+        return false;
+    }
 
     // Convert the data
     cTemp    = ((((data[0] * 256.0) + data[1]) * 175) / 65535.0) - 45;
@@ -4,14 +4,30 @@
 #include "Arduino.h"
 #include "I2C_Class.h"
 #include "Wire.h"
+#include "utility.h"
 
 #define SHT3X_I2C_ADDR 0x44
 
+#define SHT3X_MEASURE_DURATION_MS \
+    16 /**< High repeatability measurement max 15.5 ms */
+#define SHT3X_POLL_TIMEOUT_MS \
+    100 /**< Give up the measurement if not readable after this */
+
 class SHT3X {
    public:
     bool begin(TwoWire* wire = &Wire, uint8_t addr = SHT3X_I2C_ADDR,
                uint8_t sda = 21, uint8_t scl = 22, long freq = 400000U);
     bool update(void);
+
+    /** Start a measurement without waiting (split-phase with poll) */
+    bool trigger(void);
+    /** Read the measurement if ready, true if the values are updated */
+    bool poll(void);
+    /** Is a measurement in progress? */
+    bool busy(void) const {
+        return _pending;
+    }
+
     float cTemp    = 0;
     float fTemp    = 0;
     float humidity = 0;
@@ -20,6 +36,9 @@ class SHT3X {
     TwoWire* _wire;
     uint8_t _addr;
     I2C_Class _i2c;
+
+    bool _pending     = false;
+    uint32_t _readyAt = 0;
 };
 
 #endif
@@ -9,10 +9,21 @@ bool SHT4X::begin(TwoWire* wire, uint8_t addr, uint8_t sda, uint8_t scl,
 }
 
 bool SHT4X::update() {
-    uint8_t readbuffer[6];
-    uint8_t cmd       = SHT4x_NOHEAT_HIGHPRECISION;
-    uint16_t duration = 10;
+    if (!trigger()) return false;
+    int32_t wait = (int32_t)(_readyAt - millis());
+    if (wait > 0) delay(wait);
+    while (busy()) {
+        if (poll()) return true;
+        delay(1);
+    }
+    return false;
+}
 
+void SHT4X::command(uint8_t& cmd, uint16_t& duration) const {
+    // Max measurement durations from the datasheet
+    // (8.3 / 4.5 / 1.6 ms, heater 1.1 s / 0.11 s)
+    cmd      = SHT4x_NOHEAT_HIGHPRECISION;
+    duration = 10;
     if (_heater == SHT4X_NO_HEATER) {
         if (_precision == SHT4X_HIGH_PRECISION) {
             cmd      = SHT4x_NOHEAT_HIGHPRECISION;
@@ -54,12 +65,33 @@ bool SHT4X::update() {
         cmd      = SHT4x_LOWHEAT_100MS;
         duration = 110;
     }
+}
+
+bool SHT4X::trigger() {
+    uint8_t cmd;
+    uint16_t duration;
+    command(cmd, duration);
+
+    // The sensor NACKs the read header until the measurement is done
+    _wire->beginTransmission(_addr);
+    _wire->write(cmd);
+    _pending = (_wire->endTransmission() == 0);
+    _readyAt = millis() + duration;
+    return _pending;
+}
 
-    _i2c.writeByte(_addr, cmd, 1);
+bool SHT4X::poll() {
+    if (!_pending || (int32_t)(millis() - _readyAt) < 0) return false;
 
-    delay(duration);
+    uint8_t readbuffer[6];
 
-    _wire->requestFrom(_addr, (uint8_t)6);
+    if (_wire->requestFrom(_addr, (uint8_t)6) != 6) {
+        if ((int32_t)(millis() - _readyAt) > SHT4x_POLL_TIMEOUT_MS) {
+            _pending = false;
+        }
+        return false;
+    }
+    _pending = false;
 
     for (uint16_t i = 0; i < 6; i++) {
         readbuffer[i] = _wire->read();
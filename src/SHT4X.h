@@ -37,6 +37,9 @@
 #define SHT4x_READSERIAL 0x89 /**< Read Out of Serial Register */
 #define SHT4x_SOFTRESET  0x94 /**< Soft Reset */
 
+#define SHT4x_POLL_TIMEOUT_MS \
+    100 /**< Give up the measurement if not readable after this */
+
 typedef enum {
     SHT4X_HIGH_PRECISION,
     SHT4X_MED_PRECISION,
@@ -60,6 +63,15 @@ class SHT4X {
                uint8_t sda = 21, uint8_t scl = 22, long freq = 400000U);
     bool update(void);
 
+    /** Start a measurement without waiting (split-phase with poll) */
+    bool trigger(void);
+    /** Read the measurement if ready, true if the values are updated */
+    bool poll(void);
+    /** Is a measurement in progress? */
+    bool busy(void) const {
+        return _pending;
+    }
+
     float cTemp    = 0;
     float humidity = 0;
 
@@ -75,6 +87,11 @@ class SHT4X {
 
     sht4x_precision_t _precision = SHT4X_HIGH_PRECISION;
     sht4x_heater_t _heater       = SHT4X_NO_HEATER;
+
+    bool _pending     = false;
+    uint32_t _readyAt = 0;
+
+    void command(uint8_t& cmd, uint16_t& duration) const;
 };
 
 #endif
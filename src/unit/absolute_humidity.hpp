@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file absolute_humidity.hpp
+  @brief Conversion from temperature and relative humidity to absolute humidity
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+*/
+#ifndef M5_UNIT_ENV_ABSOLUTE_HUMIDITY_HPP
+#define M5_UNIT_ENV_ABSOLUTE_HUMIDITY_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace sgp30 {
+
+///@name Absolute humidity
+///@{
+//! @brief Lower limit of temperature for absolute_humidity (Celsius)
+constexpr float ABSOLUTE_HUMIDITY_TEMPERATURE_MIN{-40.0f};
+//! @brief Upper limit of temperature for absolute_humidity (Celsius)
+constexpr float ABSOLUTE_HUMIDITY_TEMPERATURE_MAX{85.0f};
+//! @brief Maximum relative error of absolute_humidity against absolute_humidity_magnus
+constexpr float ABSOLUTE_HUMIDITY_MAX_RELATIVE_ERROR{0.001f};
+
+/*!
+  @brief Absolute humidity by Magnus formula
+  @param celsius Temperature (Celsius)
+  @param rh Relative humidity (%)
+  @return Absolute humidity (g/m^3)
+  @note Formula from the SGP30 datasheet
+ */
+inline float absolute_humidity_magnus(const float celsius, const float rh)
+{
+    return 216.7f * ((rh / 100.0f) * 6.112f * std::exp((17.62f * celsius) / (243.12f + celsius)) / (273.15f + celsius));
+}
+
+/*!
+  @brief Absolute humidity without exp
+  @details Quadratic interpolation of the saturation vapour density tabulated every 2.5 Celsius
+  @param celsius Temperature (Celsius) clamped to ABSOLUTE_HUMIDITY_TEMPERATURE_MIN - MAX
+  @param rh Relative humidity (%)
+  @return Absolute humidity (g/m^3), NaN if the temperature is not finite
+  @note Relative error is less than ABSOLUTE_HUMIDITY_MAX_RELATIVE_ERROR (actual 0.074%) in the range
+ */
+inline float absolute_humidity(const float celsius, const float rh)
+{
+    // Saturation vapour density (g/m^3) from -40 to 85 Celsius in 2.5 steps
+    static constexpr float table[] = {
+        0.1767915f, 0.2260426f, 0.2872716f, 0.3629634f, 0.456027f, 0.569851f, 0.7083649f, 0.8761037f, 1.078279f,
+        1.320856f,  1.610632f,  1.955323f,  2.363657f,  2.845468f, 3.4118f,   4.075008f,  4.848876f,  5.748725f,
+        6.791539f,  7.996084f,  9.383039f,  10.97512f,  12.79724f, 14.87658f, 17.24283f,  19.92823f,  22.96778f,
+        26.39935f,  30.26383f,  34.6053f,   39.47113f,  44.91217f, 50.98286f, 57.74139f,  65.24982f,  73.57426f,
+        82.78495f,  92.95643f,  104.1676f,  116.5021f,  130.0479f, 144.898f,  161.1502f,  178.9072f,  198.277f,
+        219.3726f,  242.3123f,  267.2197f,  294.2239f,  323.4594f, 355.0663f};
+    constexpr int32_t last = sizeof(table) / sizeof(table[0]) - 3;
+    if (!std::isfinite(celsius)) {
+        return std::numeric_limits<float>::quiet_NaN();  // Never index by NaN
+    }
+
+    float t = celsius < ABSOLUTE_HUMIDITY_TEMPERATURE_MIN
+                  ? ABSOLUTE_HUMIDITY_TEMPERATURE_MIN
+                  : (celsius > ABSOLUTE_HUMIDITY_TEMPERATURE_MAX ? ABSOLUTE_HUMIDITY_TEMPERATURE_MAX : celsius);
+    float x   = (t - ABSOLUTE_HUMIDITY_TEMPERATURE_MIN) * 0.4f;
+    int32_t i = static_cast<int32_t>(x);
+    i         = i > last ? last : i;
+    float u   = x - i;
+    // Newton forward difference over table[i], table[i+1], table[i+2]
+    float d1 = table[i + 1] - table[i];
+    float d2 = table[i + 2] - 2.0f * table[i + 1] + table[i];
+    return (rh * 0.01f) * (table[i] + u * d1 + u * (u - 1.0f) * 0.5f * d2);
+}
+
+/*!
+  @brief Absolute humidity in the SGP30 register format
+  @param gm3 Absolute humidity (g/m^3)
+  @return Fixed-point 8.8bit number, clamped to 1 - 0xFFFF (1 if NaN)
+  @note Zero disables the humidity compensation, so it is never returned
+ */
+inline uint16_t absolute_humidity_to_raw(const float gm3)
+{
+    float v = gm3 * 256.0f + 0.5f;
+    return !(v >= 1.0f) ? 1 : (v >= 65535.0f ? 0xFFFF : static_cast<uint16_t>(v));
+}
+///@}
+
+///@cond
+namespace detail {
+template <class D>
+inline auto affected(const D& d, int) -> decltype(static_cast<bool>(d.affected()))
+{
+    return d.affected();
+}
+template <class D>
+inline bool affected(const D&, long)
+{
+    return false;
+}
+}  // namespace detail
+///@endcond
+
+/*!
+  @brief Is the sample usable for the humidity compensation?
+  @tparam D Measured data of UnitSHT30 or UnitSHT40
+  @return False if the sample is affected by the heater (D::affected()), always true for data without it
+ */
+template <class D>
+inline bool compensable(const D& d)
+{
+    return !detail::affected(d, 0);
+}
+
+}  // namespace sgp30
+}  // namespace unit
+}  // namespace m5
+#endif
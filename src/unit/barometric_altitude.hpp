@@ -0,0 +1,196 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file barometric_altitude.hpp
+  @brief Altitude and sea level pressure from the barometric pressure without pow
+  @details Shared by the pressure units (BMP280, QMP6988, BME688)
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+*/
+#ifndef M5_UNIT_ENV_BAROMETRIC_ALTITUDE_HPP
+#define M5_UNIT_ENV_BAROMETRIC_ALTITUDE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace barometric {
+
+///@name Constants
+///@{
+//! @brief Standard sea level pressure (Pa)
+constexpr float STANDARD_SEA_LEVEL_PRESSURE{101325.0f};
+//! @brief Lower limit of pressure for altitude (Pa)
+constexpr float PRESSURE_MIN{30000.0f};
+//! @brief Upper limit of pressure for altitude (Pa)
+constexpr float PRESSURE_MAX{110000.0f};
+//! @brief Lower limit of altitude for sea_level_pressure (m)
+constexpr float ALTITUDE_MIN{-1000.0f};
+//! @brief Upper limit of altitude for sea_level_pressure (m)
+constexpr float ALTITUDE_MAX{9500.0f};
+//! @brief Maximum absolute error of altitude against altitude_pow in the pressure range (m)
+constexpr float ALTITUDE_MAX_ERROR{0.25f};
+//! @brief Maximum relative error of sea_level_pressure against sea_level_pressure_pow in the altitude range
+constexpr float SEA_LEVEL_PRESSURE_MAX_RELATIVE_ERROR{0.00001f};
+///@}
+
+///@cond
+namespace detail {
+// International barometric formula (ISA troposphere)
+constexpr float SCALE{44330.77f};
+constexpr float EXPONENT{1.0f / 5.25588f};
+
+template <typename T>
+inline T clamp(const T v, const T lo, const T hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Quadratic interpolation by Newton forward difference over table[i], table[i+1], table[i+2]
+inline float interpolate(const float* table, const int32_t last, const float x)
+{
+    int32_t i = static_cast<int32_t>(x);
+    i         = i > last ? last : i;
+    float u   = x - i;
+    float d1  = table[i + 1] - table[i];
+    float d2  = table[i + 2] - 2.0f * table[i + 1] + table[i];
+    return table[i] + u * d1 + u * (u - 1.0f) * 0.5f * d2;
+}
+
+// hPa^EXPONENT from 300 to 1100 hPa every 20 hPa
+inline float power(const float pa)
+{
+    static constexpr float table[] = {
+        2.9600889f, 2.9966608f, 3.0314263f, 3.0645734f, 3.0962614f, 3.1266264f, 3.1557859f, 3.1838419f,
+        3.2108835f, 3.2369893f, 3.2622286f, 3.2866632f, 3.3103483f, 3.3333335f, 3.3556632f, 3.3773779f,
+        3.3985142f, 3.4191054f, 3.439182f, 3.4587718f, 3.4779006f, 3.4965917f, 3.5148671f, 3.5327468f,
+        3.5502495f, 3.5673924f, 3.5841918f, 3.6006626f, 3.6168189f, 3.6326737f, 3.6482394f, 3.6635274f,
+        3.6785487f, 3.6933134f, 3.707831f, 3.7221107f, 3.736161f, 3.7499899f, 3.7636052f, 3.777014f,
+        3.7902232f, 3.8032394f, 3.8160687f,
+    };
+    constexpr int32_t last = sizeof(table) / sizeof(table[0]) - 3;
+    if (!std::isfinite(pa)) {
+        return std::numeric_limits<float>::quiet_NaN();  // clamp passes NaN through, never index by it
+    }
+    return interpolate(table, last, (clamp(pa, PRESSURE_MIN, PRESSURE_MAX) - PRESSURE_MIN) * (1.0f / 2000.0f));
+}
+
+// (1 - m / SCALE)^(-1/EXPONENT) from -1000 to 9500 m every 250 m
+inline float reduction(const float altitude)
+{
+    static constexpr float table[] = {
+        0.88936897f, 0.91559917f, 0.94275536f, 0.97087566f, 1.0f, 1.0301702f, 1.0614301f, 1.0938255f,
+        1.1274047f, 1.162218f, 1.1983184f, 1.2357614f, 1.2746052f, 1.3149111f, 1.3567432f, 1.400169f,
+        1.4452593f, 1.4920886f, 1.5407351f, 1.5912811f, 1.6438133f, 1.6984226f, 1.755205f, 1.8142614f,
+        1.8756981f, 1.9396271f, 2.0061664f, 2.0754405f, 2.1475805f, 2.222725f, 2.30102f, 2.3826197f,
+        2.4676871f, 2.5563942f, 2.6489228f, 2.7454654f, 2.8462251f, 2.9514172f, 3.0612694f, 3.1760229f,
+        3.2959331f, 3.4212708f, 3.5523229f, 3.6893938f, 3.8328065f,
+    };
+    constexpr int32_t last = sizeof(table) / sizeof(table[0]) - 3;
+    if (!std::isfinite(altitude)) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    return interpolate(table, last, (clamp(altitude, ALTITUDE_MIN, ALTITUDE_MAX) - ALTITUDE_MIN) * (1.0f / 250.0f));
+}
+}  // namespace detail
+///@endcond
+
+///@name Altitude
+///@{
+/*!
+  @brief Altitude by the international barometric formula with pow
+  @param pa Pressure (Pa)
+  @param sea_level Sea level pressure (Pa)
+  @return Altitude (m)
+ */
+inline float altitude_pow(const float pa, const float sea_level = STANDARD_SEA_LEVEL_PRESSURE)
+{
+    return detail::SCALE * (1.0f - std::pow(pa / sea_level, detail::EXPONENT));
+}
+
+/*!
+  @brief Altitude without pow
+  @details Quadratic interpolation of p^(1/5.25588) tabulated every 20 hPa
+  @param pa Pressure (Pa) clamped to PRESSURE_MIN - MAX
+  @param sea_level Sea level pressure (Pa) clamped to PRESSURE_MIN - MAX
+  @return Altitude (m), NaN if the pressure or the sea level pressure is not finite
+  @note Absolute error is less than ALTITUDE_MAX_ERROR in the range (below the resolution of the sensors)
+ */
+inline float altitude(const float pa, const float sea_level = STANDARD_SEA_LEVEL_PRESSURE)
+{
+    return detail::SCALE * (1.0f - detail::power(pa) / detail::power(sea_level));
+}
+
+/*!
+  @brief Altitude of the pressures
+  @param[out] out Output (n elements)
+  @param pa Pressures (Pa)
+  @param n Number of the elements
+  @param sea_level Sea level pressure (Pa)
+  @note The sea level term is evaluated once
+ */
+inline void altitudes(float* out, const float* pa, const size_t n, const float sea_level = STANDARD_SEA_LEVEL_PRESSURE)
+{
+    const float inv = 1.0f / detail::power(sea_level);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = detail::SCALE * (1.0f - detail::power(pa[i]) * inv);
+    }
+}
+
+/*!
+  @brief Altitude of the data
+  @tparam It Iterator of the data having pressure() in Pa (bmp280::Data, qmp6988::Data...)
+  @tparam Out Output iterator of float
+  @param first,last Range of the data (e.g. the buffer snapshot)
+  @param out Output
+  @param sea_level Sea level pressure (Pa)
+  @return Output iterator to the element past the last written
+  @note The sea level term is evaluated once
+ */
+template <class It, class Out>
+inline Out transform_altitude(It first, It last, Out out, const float sea_level = STANDARD_SEA_LEVEL_PRESSURE)
+{
+    const float inv = 1.0f / detail::power(sea_level);
+    for (; first != last; ++first) {
+        *out++ = detail::SCALE * (1.0f - detail::power(first->pressure()) * inv);
+    }
+    return out;
+}
+///@}
+
+///@name Sea level pressure
+///@{
+/*!
+  @brief Sea level pressure (QNH) with pow
+  @param pa Pressure at the altitude (Pa)
+  @param altitude Altitude (m)
+  @return Sea level pressure (Pa)
+ */
+inline float sea_level_pressure_pow(const float pa, const float altitude)
+{
+    return pa / std::pow(1.0f - altitude / detail::SCALE, 1.0f / detail::EXPONENT);
+}
+
+/*!
+  @brief Sea level pressure (QNH) without pow
+  @details Quadratic interpolation of the reduction factor tabulated every 250 m
+  @param pa Pressure at the altitude (Pa)
+  @param altitude Altitude (m) clamped to ALTITUDE_MIN - MAX
+  @return Sea level pressure (Pa), NaN if the pressure or the altitude is not finite
+  @note Relative error is less than SEA_LEVEL_PRESSURE_MAX_RELATIVE_ERROR in the range
+ */
+inline float sea_level_pressure(const float pa, const float altitude)
+{
+    return pa * detail::reduction(altitude);
+}
+///@}
+
+}  // namespace barometric
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file blob_storage.hpp
+  @brief Storage backend for persisting sensor states across reboots
+*/
+#ifndef M5_UNIT_ENV_BLOB_STORAGE_HPP
+#define M5_UNIT_ENV_BLOB_STORAGE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(ARDUINO) && defined(ESP32)
+#include <Preferences.h>
+#endif
+
+namespace m5 {
+namespace unit {
+
+/*!
+  @class BlobStorage
+  @brief Interface of the key-value storage that holds binary blobs
+  @details Implement this for the storage of your choice (NVS, SD, EEPROM...)
+ */
+class BlobStorage {
+public:
+    virtual ~BlobStorage()
+    {
+    }
+    /*!
+      @brief Read the blob
+      @param key Key of the blob
+      @param[out] buf Output buffer
+      @param len Length to be read
+      @return True if successful and exactly len bytes were read
+     */
+    virtual bool read(const char* key, uint8_t* buf, const size_t len) = 0;
+    /*!
+      @brief Write the blob
+      @param key Key of the blob
+      @param buf Blob
+      @param len Length of the blob
+      @return True if successful
+     */
+    virtual bool write(const char* key, const uint8_t* buf, const size_t len) = 0;
+};
+
+/*!
+  @class MemoryBlobStorage
+  @brief Volatile storage for a single blob
+  @details Survives only while the instance is alive (e.g. placed in RTC memory for deep sleep)
+  @tparam N Capacity of the blob
+ */
+template <size_t N>
+class MemoryBlobStorage : public BlobStorage {
+public:
+    virtual bool read(const char*, uint8_t* buf, const size_t len) override
+    {
+        if (!buf || len != _len) {
+            return false;
+        }
+        std::memcpy(buf, _buf, len);
+        return true;
+    }
+    virtual bool write(const char*, const uint8_t* buf, const size_t len) override
+    {
+        if (!buf || len > N) {
+            return false;
+        }
+        std::memcpy(_buf, buf, len);
+        _len = len;
+        return true;
+    }
+
+private:
+    uint8_t _buf[N]{};
+    size_t _len{};
+};
+
+#if defined(ARDUINO) && defined(ESP32)
+/*!
+  @class PreferencesBlobStorage
+  @brief Storage using the NVS through Arduino Preferences
+ */
+class PreferencesBlobStorage : public BlobStorage {
+public:
+    //! @param name Namespace of the Preferences (15 characters max)
+    explicit PreferencesBlobStorage(const char* name = "m5unitenv") : _name{name}
+    {
+    }
+    virtual bool read(const char* key, uint8_t* buf, const size_t len) override
+    {
+        Preferences prefs;
+        if (!prefs.begin(_name, true)) {
+            return false;
+        }
+        bool ret = prefs.getBytesLength(key) == len && prefs.getBytes(key, buf, len) == len;
+        prefs.end();
+        return ret;
+    }
+    virtual bool write(const char* key, const uint8_t* buf, const size_t len) override
+    {
+        Preferences prefs;
+        if (!prefs.begin(_name, false)) {
+            return false;
+        }
+        bool ret = prefs.putBytes(key, buf, len) == len;
+        prefs.end();
+        return ret;
+    }
+
+private:
+    const char* _name{};
+};
+#endif
+
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,208 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file bme688_field_decoder.hpp
+  @brief Local decoder of the BME688 field data read in one burst
+  @details Decodes the same bme68x_data as bme68x_get_data from the registers 0x1D - 0x6D
+  (3 field blocks followed by the idac/res_heat/gas_wait settings)
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+  @note Compensation formulas are from BME68x Sensor API (BSD-3-Clause) with BME68X_USE_FPU
+  @note Only available if BME68X_USE_FPU (bme68x_data has the floating point fields),
+  UnitBME688 uses bme68x_get_data otherwise
+*/
+#ifndef M5_UNIT_ENV_BME688_FIELD_DECODER_HPP
+#define M5_UNIT_ENV_BME688_FIELD_DECODER_HPP
+
+#include <bme68x/bme68x_defs.h>
+#include <cstdint>
+
+#if defined(BME68X_USE_FPU)
+
+namespace m5 {
+namespace unit {
+namespace bme688 {
+namespace burst {
+
+///@name Burst window
+///@{
+constexpr uint8_t START{0x1D};          //!< @brief First register (status of field 0)
+constexpr uint8_t FIELD_LENGTH{17};     //!< @brief Length of each field block
+constexpr uint8_t FIELDS{3};            //!< @brief Number of field blocks
+constexpr uint8_t SETTINGS_OFFSET{51};  //!< @brief Offset of IDAC_HEATER_0 (0x50) in the window
+constexpr uint8_t LENGTH{81};           //!< @brief Length of the window (0x1D - 0x6D)
+///@}
+
+///@name Compensation
+///@{
+//! @brief Compensated temperature (Celsius), updates calib.t_fine
+inline float calc_temperature(const uint32_t adc, bme68x_calib_data& calib)
+{
+    float var1 = ((((float)adc / 16384.0f) - ((float)calib.par_t1 / 1024.0f)) * ((float)calib.par_t2));
+    float var2 = (((((float)adc / 131072.0f) - ((float)calib.par_t1 / 8192.0f)) *
+                   (((float)adc / 131072.0f) - ((float)calib.par_t1 / 8192.0f))) *
+                  ((float)calib.par_t3 * 16.0f));
+    calib.t_fine = (var1 + var2);
+    return calib.t_fine / 5120.0f;
+}
+
+//! @brief Compensated pressure (Pa), calib.t_fine must be updated by calc_temperature
+inline float calc_pressure(const uint32_t adc, const bme68x_calib_data& calib)
+{
+    float var1 = (((float)calib.t_fine / 2.0f) - 64000.0f);
+    float var2 = var1 * var1 * (((float)calib.par_p6) / (131072.0f));
+    var2       = var2 + (var1 * ((float)calib.par_p5) * 2.0f);
+    var2       = (var2 / 4.0f) + (((float)calib.par_p4) * 65536.0f);
+    var1 = (((((float)calib.par_p3 * var1 * var1) / 16384.0f) + ((float)calib.par_p2 * var1)) / 524288.0f);
+    var1 = ((1.0f + (var1 / 32768.0f)) * ((float)calib.par_p1));
+    float pres = (1048576.0f - ((float)adc));
+    // Avoid exception caused by division by zero
+    if ((int)var1 == 0) {
+        return 0.0f;
+    }
+    pres       = (((pres - (var2 / 4096.0f)) * 6250.0f) / var1);
+    var1       = (((float)calib.par_p9) * pres * pres) / 2147483648.0f;
+    var2       = pres * (((float)calib.par_p8) / 32768.0f);
+    float var3 = ((pres / 256.0f) * (pres / 256.0f) * (pres / 256.0f) * (calib.par_p10 / 131072.0f));
+    return (pres + (var1 + var2 + var3 + ((float)calib.par_p7 * 128.0f)) / 16.0f);
+}
+
+//! @brief Compensated humidity (%RH), calib.t_fine must be updated by calc_temperature
+inline float calc_humidity(const uint16_t adc, const bme68x_calib_data& calib)
+{
+    float temp_comp = ((calib.t_fine) / 5120.0f);
+    float var1 =
+        (float)((float)adc) - (((float)calib.par_h1 * 16.0f) + (((float)calib.par_h3 / 2.0f) * temp_comp));
+    float var2 = var1 * ((float)(((float)calib.par_h2 / 262144.0f) *
+                                 (1.0f + (((float)calib.par_h4 / 16384.0f) * temp_comp) +
+                                  (((float)calib.par_h5 / 1048576.0f) * temp_comp * temp_comp))));
+    float var3 = (float)calib.par_h6 / 16384.0f;
+    float var4 = (float)calib.par_h7 / 2097152.0f;
+    float hum  = var2 + ((var3 + (var4 * temp_comp)) * var2 * var2);
+    return hum > 100.0f ? 100.0f : (hum < 0.0f ? 0.0f : hum);
+}
+
+//! @brief Gas resistance (Ohm) for the variant BME680
+inline float calc_gas_resistance_low(const uint16_t adc, const uint8_t range, const bme68x_calib_data& calib)
+{
+    static constexpr float lookup_k1_range[16] = {0.0f, 0.0f, 0.0f,  0.0f,  0.0f, -1.0f, 0.0f, -0.8f,
+                                                  0.0f, 0.0f, -0.2f, -0.5f, 0.0f, -1.0f, 0.0f, 0.0f};
+    static constexpr float lookup_k2_range[16] = {0.0f, 0.0f, 0.0f, 0.0f, 0.1f, 0.7f, 0.0f, -0.8f,
+                                                  -0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    float gas_res_f   = adc;
+    float gas_range_f = (1U << range);
+    float var1        = (1340.0f + (5.0f * calib.range_sw_err));
+    float var2        = (var1) * (1.0f + lookup_k1_range[range] / 100.0f);
+    float var3        = 1.0f + (lookup_k2_range[range] / 100.0f);
+    return 1.0f / (float)(var3 * (0.000000125f) * gas_range_f * (((gas_res_f - 512.0f) / var2) + 1.0f));
+}
+
+//! @brief Gas resistance (Ohm) for the variant BME688
+inline float calc_gas_resistance_high(const uint16_t adc, const uint8_t range)
+{
+    uint32_t var1 = UINT32_C(262144) >> range;
+    int32_t var2  = (int32_t)adc - INT32_C(512);
+    var2 *= INT32_C(3);
+    var2 = INT32_C(4096) + var2;
+    return 1000000.0f * (float)var1 / (float)var2;
+}
+///@}
+
+/*!
+  @brief Decode a field block
+  @param[out] data Output
+  @param field Field block (17 bytes)
+  @param settings IDAC_HEATER_0 - GAS_WAIT_9 (30 bytes)
+  @param calib Calibration (t_fine is updated)
+  @param gas_high Variant is BME688?
+  @return True if the field has new data
+ */
+inline bool decode_field(bme68x_data& data, const uint8_t* field, const uint8_t* settings, bme68x_calib_data& calib,
+                         const bool gas_high)
+{
+    data.status     = field[0] & BME68X_NEW_DATA_MSK;
+    data.gas_index  = field[0] & BME68X_GAS_INDEX_MSK;
+    data.meas_index = field[1];
+
+    uint32_t adc_pres = ((uint32_t)field[2] << 12) | ((uint32_t)field[3] << 4) | ((uint32_t)field[4] >> 4);
+    uint32_t adc_temp = ((uint32_t)field[5] << 12) | ((uint32_t)field[6] << 4) | ((uint32_t)field[7] >> 4);
+    uint16_t adc_hum  = ((uint16_t)field[8] << 8) | field[9];
+    // Gas ADC, range and status are placed at 13,14 (BME680) or 15,16 (BME688)
+    const uint8_t* gas = field + (gas_high ? 15 : 13);
+    uint16_t adc_gas   = ((uint16_t)gas[0] << 2) | (gas[1] >> 6);
+    uint8_t gas_range  = gas[1] & BME68X_GAS_RANGE_MSK;
+    data.status |= gas[1] & (BME68X_GASM_VALID_MSK | BME68X_HEAT_STAB_MSK);
+
+    data.idac     = settings[data.gas_index];
+    data.res_heat = settings[10 + data.gas_index];
+    data.gas_wait = settings[20 + data.gas_index];
+
+    data.temperature    = calc_temperature(adc_temp, calib);
+    data.pressure       = calc_pressure(adc_pres, calib);
+    data.humidity       = calc_humidity(adc_hum, calib);
+    data.gas_resistance = gas_high ? calc_gas_resistance_high(adc_gas, gas_range)
+                                   : calc_gas_resistance_low(adc_gas, gas_range, calib);
+    return data.status & BME68X_NEW_DATA_MSK;
+}
+
+/*!
+  @brief Decode the burst window as bme68x_get_data does
+  @param[out] data Output (3 elements), ordered by measurement index if parallel/sequential
+  @param window Registers 0x1D - 0x6D (LENGTH bytes)
+  @param op_mode BME68X_FORCED_MODE, BME68X_PARALLEL_MODE or BME68X_SEQUENTIAL_MODE
+  @param calib Calibration (t_fine is updated)
+  @param variant_id Variant of the chip
+  @return Number of new data
+  @note Forced mode decodes only the field 0
+ */
+inline uint8_t decode(bme68x_data data[3], const uint8_t* window, const uint8_t op_mode, bme68x_calib_data& calib,
+                      const uint32_t variant_id)
+{
+    const bool gas_high     = (variant_id == BME68X_VARIANT_GAS_HIGH);
+    const uint8_t* settings = window + SETTINGS_OFFSET;
+
+    if (op_mode == BME68X_FORCED_MODE) {
+        return decode_field(data[0], window, settings, calib, gas_high) ? 1 : 0;
+    }
+    if (op_mode != BME68X_PARALLEL_MODE && op_mode != BME68X_SEQUENTIAL_MODE) {
+        return 0;
+    }
+
+    bme68x_data fields[FIELDS]{};
+    bme68x_data* ptr[FIELDS] = {&fields[0], &fields[1], &fields[2]};
+    uint8_t num{};
+    for (uint_fast8_t i = 0; i < FIELDS; ++i) {
+        num += decode_field(fields[i], window + i * FIELD_LENGTH, settings, calib, gas_high);
+    }
+    // Same ordering as sort_sensor_data in bme68x.c
+    for (uint_fast8_t i = 0; i < FIELDS - 1; ++i) {
+        for (uint_fast8_t j = i + 1; j < FIELDS; ++j) {
+            bool swap{};
+            if ((ptr[i]->status & BME68X_NEW_DATA_MSK) && (ptr[j]->status & BME68X_NEW_DATA_MSK)) {
+                int16_t diff = (int16_t)ptr[j]->meas_index - (int16_t)ptr[i]->meas_index;
+                swap         = ((diff > -3) && (diff < 0)) || (diff > 2);
+            } else {
+                swap = ptr[j]->status & BME68X_NEW_DATA_MSK;
+            }
+            if (swap) {
+                bme68x_data* tmp = ptr[i];
+                ptr[i]           = ptr[j];
+                ptr[j]           = tmp;
+            }
+        }
+    }
+    for (uint_fast8_t i = 0; i < FIELDS; ++i) {
+        data[i] = *ptr[i];
+    }
+    return num;
+}
+
+}  // namespace burst
+}  // namespace bme688
+}  // namespace unit
+}  // namespace m5
+
+#endif
+#endif
@@ -0,0 +1,206 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file bme688_iaq_estimator.hpp
+  @brief Open IAQ estimation for BME688 without BSEC2
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+*/
+#ifndef M5_UNIT_ENV_BME688_IAQ_ESTIMATOR_HPP
+#define M5_UNIT_ENV_BME688_IAQ_ESTIMATOR_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace bme688 {
+
+/*!
+  @class IAQEstimator
+  @brief Indoor air quality index (0 - 500) from the raw gas resistance and humidity
+  @details
+  - The gas resistance is compensated for humidity in the log domain (ln(R) + slope * RH)
+  - The baseline follows the cleanest air seen, rising quickly and decaying slowly
+  - The index combines the gas score (ratio to the baseline) and the humidity score (distance from the reference)
+  like the BSEC2 scale, 0 is the best and 500 the worst
+  @note Fixed memory and constant cost (one log) per sample
+  @note Not compatible with the BSEC2 IAQ, use it where BSEC2 is not available (e.g. NanoC6)
+  @code
+  m5::unit::bme688::IAQEstimator iaq;
+  if (unit.updated()) {
+      iaq.update(unit.latest());
+      M5_LOGI("IAQ:%.1f (%u)", iaq.iaq(), iaq.accuracy());
+  }
+  @endcode
+ */
+class IAQEstimator {
+public:
+    /*!
+      @struct config_t
+      @brief Settings for estimation
+      @note The number of samples depends on the measurement interval (defaults assume 3 seconds)
+     */
+    struct config_t {
+        //! Samples ignored while the heater plate stabilizes
+        uint32_t burn_in{100};
+        //! Samples to learn the baseline after the burn-in
+        uint32_t learning{1200};
+        //! Humidity compensation slope of ln(Ohm) per %RH
+        float humidity_slope{0.04f};
+        //! Ideal relative humidity (%RH)
+        float humidity_reference{40.0f};
+        //! Weight of the humidity score (0.0 - 1.0), the rest is the gas score
+        float humidity_weight{0.25f};
+        //! Range of ln(R/baseline) mapped to the gas score (ln(5): 1/5 of the baseline is the worst)
+        float gas_range{1.609438f};
+        //! Smoothing factor when the air is cleaner than the baseline
+        float baseline_rise{0.05f};
+        //! Smoothing factor when the air is dirtier than the baseline (time constant about 1 day)
+        float baseline_fall{1.0f / 28800};
+    };
+
+    IAQEstimator()
+    {
+    }
+    explicit IAQEstimator(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration */
+    inline const config_t& config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configuration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Feed the data
+      @tparam D bme688::Data or any with raw_gas() and raw_humidity()
+      @return IAQ
+     */
+    template <class D>
+    inline float update(const D& d)
+    {
+        return update(d.raw_gas(), d.raw_humidity());
+    }
+
+    /*!
+      @brief Feed the values
+      @param ohm Gas resistance (Ohm)
+      @param rh Relative humidity (%RH)
+      @return IAQ (0 - 500), NaN while burn-in
+      @note Invalid values are ignored
+     */
+    float update(const float ohm, const float rh)
+    {
+        if (!(ohm > 0.0f) || std::isnan(rh)) {
+            return _iaq;
+        }
+        ++_samples;
+        const float g = std::log(ohm) + _cfg.humidity_slope * rh;
+        if (_samples <= _cfg.burn_in) {
+            return _iaq;
+        }
+        if (_samples == _cfg.burn_in + 1 && !_restored) {
+            _baseline = g;
+        }
+        // Faster learning until learned
+        const float fall = learned() ? _cfg.baseline_fall : _cfg.baseline_fall * 16.0f;
+        _baseline += (g > _baseline ? _cfg.baseline_rise : fall) * (g - _baseline);
+
+        float gas_score = 1.0f + (g - _baseline) / _cfg.gas_range;
+        gas_score       = gas_score < 0.0f ? 0.0f : (gas_score > 1.0f ? 1.0f : gas_score);
+
+        const float ref   = _cfg.humidity_reference;
+        float hum_score   = (rh >= ref) ? (100.0f - rh) / (100.0f - ref) : rh / ref;
+        hum_score         = hum_score < 0.0f ? 0.0f : (hum_score > 1.0f ? 1.0f : hum_score);
+        const float score = _cfg.humidity_weight * hum_score + (1.0f - _cfg.humidity_weight) * gas_score;
+        _iaq              = (1.0f - score) * 500.0f;
+        return _iaq;
+    }
+
+    //! @brief Latest IAQ (0 - 500), NaN while burn-in
+    inline float iaq() const
+    {
+        return _iaq;
+    }
+    /*!
+      @brief Accuracy like BSEC2
+      @return 0:Burn-in 1,2:Learning the baseline 3:Learned
+     */
+    inline uint8_t accuracy() const
+    {
+        if (_samples <= _cfg.burn_in) {
+            return 0;
+        }
+        const uint32_t n = _samples - _cfg.burn_in;
+        return (_restored || n >= _cfg.learning) ? 3 : (n * 2 >= _cfg.learning ? 2 : 1);
+    }
+    //! @brief Is the baseline learned?
+    inline bool learned() const
+    {
+        return accuracy() == 3;
+    }
+    //! @brief Number of the valid samples
+    inline uint32_t samples() const
+    {
+        return _samples;
+    }
+
+    ///@name Baseline
+    ///@{
+    /*!
+      @brief Gets the baseline
+      @return Compensated baseline in ln(Ohm) + slope * RH, NaN if not yet
+      @note Store it to skip the learning on the next boot
+     */
+    inline float baseline() const
+    {
+        return _baseline;
+    }
+    /*!
+      @brief Restore the baseline
+      @param baseline Value from baseline()
+      @note Burn-in is still required, but the learning is skipped
+     */
+    inline void baseline(const float baseline)
+    {
+        if (std::isfinite(baseline)) {
+            _baseline = baseline;
+            _restored = true;
+        }
+    }
+    ///@}
+
+    //! @brief Reset the estimation
+    inline void reset()
+    {
+        _iaq      = std::numeric_limits<float>::quiet_NaN();
+        _baseline = std::numeric_limits<float>::quiet_NaN();
+        _samples  = 0;
+        _restored = false;
+    }
+
+private:
+    config_t _cfg{};
+    float _iaq{std::numeric_limits<float>::quiet_NaN()};
+    float _baseline{std::numeric_limits<float>::quiet_NaN()};
+    uint32_t _samples{};
+    bool _restored{};
+};
+
+}  // namespace bme688
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file bme688_state_manager.cpp
+  @brief Persisting the BSEC2 state of BME688 across reboots
+*/
+#include "bme688_state_manager.hpp"
+#if defined(UNIT_BME688_USING_BSEC2)
+#include <M5Utility.hpp>
+#include <cstring>
+
+using namespace m5::unit::bme688;
+
+namespace m5 {
+namespace unit {
+namespace bme688 {
+
+bool StateManager::read_slot(const uint8_t slot, uint8_t* buf, uint32_t& seq)
+{
+    if (!_storage.read(_cfg.keys[slot], buf, SLOT_SIZE)) {
+        return false;
+    }
+    state_slot::Header h{};
+    if (!state_slot::decode(buf, BSEC_MAX_STATE_BLOB_SIZE, h)) {
+        M5_LIB_LOGW("Broken slot %u", slot);
+        ++_counter.corrupted;
+        return false;
+    }
+    seq = h.sequence;
+    return true;
+}
+
+bool StateManager::load()
+{
+    uint8_t tmp[SLOT_SIZE]{};
+    uint32_t seq0{}, seq1{};
+    bool valid0 = read_slot(0, _buf, seq0);
+    bool valid1 = read_slot(1, tmp, seq1);
+
+    // Newest one (sequence may wrap around)
+    int newest = state_slot::select(valid0, seq0, valid1, seq1);
+    _loaded    = newest >= 0;
+    if (_loaded) {
+        if (newest == 1) {
+            std::memcpy(_buf, tmp, SLOT_SIZE);
+        }
+        _slot     = newest;
+        _sequence = newest ? seq1 : seq0;
+        _accuracy = _buf[3];
+        M5_LIB_LOGI("Loaded slot %u seq:%u accuracy:%u", _slot, _sequence, _accuracy);
+    }
+
+    auto cfg  = _unit.config();
+    cfg.state = _loaded ? _buf + HEADER_SIZE : nullptr;
+    _unit.config(cfg);
+    _saved_at = m5::utility::millis();
+    return _loaded;
+}
+
+void StateManager::update()
+{
+    if (!_unit.updated() || _unit.empty()) {
+        return;
+    }
+
+    auto acc = _unit.latest().iaq_accuracy();
+    auto at  = m5::utility::millis();
+    // Not every sample while the storage keeps failing
+    if (_retrying && at - _failed_at < _cfg.retry_interval) {
+        return;
+    }
+    if ((_cfg.save_on_accuracy && acc > _accuracy) || at - _saved_at >= _cfg.interval) {
+        _retrying = !save();
+        if (_retrying) {
+            _failed_at = at;
+            return;
+        }
+        _saved_at = at;
+        _accuracy = acc;
+    }
+}
+
+bool StateManager::save()
+{
+    uint8_t buf[SLOT_SIZE]{};
+    uint32_t len{};
+    if (!_unit.bsec2GetState(buf + HEADER_SIZE, len) || len > BSEC_MAX_STATE_BLOB_SIZE) {
+        M5_LIB_LOGE("Failed to get state");
+        ++_counter.failed;
+        return false;
+    }
+
+    uint8_t slot = _slot ^ 1;  // Never overwrite the last good slot
+    state_slot::Header h{};
+    h.accuracy = _unit.empty() ? 0 : _unit.latest().iaq_accuracy();
+    h.sequence = _sequence + 1;
+    h.length   = len;
+    state_slot::encode(buf, BSEC_MAX_STATE_BLOB_SIZE, h);
+
+    if (!_storage.write(_cfg.keys[slot], buf, sizeof(buf))) {
+        M5_LIB_LOGE("Failed to write slot %u", slot);
+        ++_counter.failed;
+        return false;
+    }
+    _slot     = slot;
+    _sequence = h.sequence;
+    ++_counter.saved;
+    M5_LIB_LOGD("Saved slot %u seq:%u", slot, h.sequence);
+    return true;
+}
+
+}  // namespace bme688
+}  // namespace unit
+}  // namespace m5
+#endif
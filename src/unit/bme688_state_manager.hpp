@@ -0,0 +1,152 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file bme688_state_manager.hpp
+  @brief Persisting the BSEC2 state of BME688 across reboots
+*/
+#ifndef M5_UNIT_ENV_BME688_STATE_MANAGER_HPP
+#define M5_UNIT_ENV_BME688_STATE_MANAGER_HPP
+
+#include "unit_BME688.hpp"
+#include "blob_storage.hpp"
+#include "bme688_state_slot.hpp"
+
+#if defined(UNIT_BME688_USING_BSEC2) || defined(DOXYGEN_PROCESS)
+
+namespace m5 {
+namespace unit {
+namespace bme688 {
+
+/*!
+  @class StateManager
+  @brief Saves the BSEC2 state to the storage and restores it on UnitBME688::begin
+  @details The state is saved periodically and when the IAQ accuracy rises.
+  Two slots are written alternately, each protected by a sequence number and CRC32,
+  so a power cut while writing never loses the last good state
+  @sa bme688_state_slot.hpp for the layout of the slot
+  @code
+  m5::unit::UnitENVPro envpro;
+  m5::unit::PreferencesBlobStorage storage;
+  m5::unit::bme688::StateManager manager(envpro, storage);
+  void setup() {
+      manager.load();  // Before begin
+      // add and begin UnitUnified
+  }
+  void loop() {
+      Units.update();
+      manager.update();
+  }
+  @endcode
+ */
+class StateManager {
+public:
+    //! @brief Size of the slot header
+    static constexpr size_t HEADER_SIZE{state_slot::HEADER_SIZE};
+    //! @brief Size of the slot
+    static constexpr size_t SLOT_SIZE{HEADER_SIZE + BSEC_MAX_STATE_BLOB_SIZE};
+
+    /*!
+      @struct config_t
+      @brief Settings for the manager
+     */
+    struct config_t {
+        //! Interval of saving (ms)
+        uint32_t interval{6 * 60 * 60 * 1000U};
+        //! Interval of retrying after a failed save (ms)
+        uint32_t retry_interval{60 * 1000U};
+        //! Save when the IAQ accuracy rises?
+        bool save_on_accuracy{true};
+        //! Keys of the two slots
+        const char* keys[2]{"bme688s0", "bme688s1"};
+    };
+
+    /*!
+      @struct Counter
+      @brief Statistics of the manager
+     */
+    struct Counter {
+        uint32_t saved{};      //!< @brief Number of successful saves
+        uint32_t failed{};     //!< @brief Number of failed saves
+        uint32_t corrupted{};  //!< @brief Number of broken slots found on load
+    };
+
+    StateManager(UnitBME688& unit, BlobStorage& storage) : _unit{unit}, _storage{storage}
+    {
+    }
+    StateManager(UnitBME688& unit, BlobStorage& storage, const config_t& cfg)
+        : _unit{unit}, _storage{storage}, _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration */
+    inline const config_t& config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configuration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Load the newest valid slot and pass it to the unit configuration
+      @return True if a valid state was found
+      @warning Call before UnitBME688::begin
+     */
+    bool load();
+    /*!
+      @brief Save the state when it is due
+      @note Call after UnitUnified::update()
+     */
+    void update();
+    /*!
+      @brief Save the state now
+      @return True if successful
+     */
+    bool save();
+
+    //! @brief Was a valid state found by load()?
+    inline bool loaded() const
+    {
+        return _loaded;
+    }
+    //! @brief Gets the sequence number of the newest slot
+    inline uint32_t sequence() const
+    {
+        return _sequence;
+    }
+    //! @brief Gets the statistics
+    inline const Counter& counter() const
+    {
+        return _counter;
+    }
+
+protected:
+    bool read_slot(const uint8_t slot, uint8_t* buf, uint32_t& seq);
+
+private:
+    UnitBME688& _unit;
+    BlobStorage& _storage;
+    config_t _cfg{};
+    Counter _counter{};
+    bool _loaded{};
+    uint8_t _slot{1};  // Slot written last
+    uint32_t _sequence{};
+    uint8_t _accuracy{};  // IAQ accuracy at the last save
+    bool _retrying{};     // Last save failed
+    types::elapsed_time_t _saved_at{}, _failed_at{};
+    uint8_t _buf[SLOT_SIZE]{};
+};
+
+}  // namespace bme688
+}  // namespace unit
+}  // namespace m5
+#endif
+#endif
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file bme688_state_slot.hpp
+  @brief Slot codec of the persisted BSEC2 state used by bme688::StateManager
+  @details Slot layout (little endian)
+  |Offset|Size|Content|
+  |---|---|---|
+  |0|2|MAGIC ('B', 'S')|
+  |2|1|VERSION|
+  |3|1|IAQ accuracy at the save|
+  |4|4|Sequence number|
+  |8|4|Length of the state|
+  |12|4|CRC-32 (IEEE 802.3) of the bytes 0 - 11 and the whole state area|
+  |16|capacity|State|
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+*/
+#ifndef M5_UNIT_ENV_BME688_STATE_SLOT_HPP
+#define M5_UNIT_ENV_BME688_STATE_SLOT_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace m5 {
+namespace unit {
+namespace bme688 {
+namespace state_slot {
+
+constexpr size_t HEADER_SIZE{16};  //!< @brief Size of the slot header
+constexpr uint8_t MAGIC0{'B'};     //!< @brief First byte of the magic
+constexpr uint8_t MAGIC1{'S'};     //!< @brief Second byte of the magic
+constexpr uint8_t VERSION{1};      //!< @brief Version of the layout
+
+/*!
+  @struct Header
+  @brief Contents of the slot header
+ */
+struct Header {
+    uint8_t accuracy{};   //!< IAQ accuracy at the save
+    uint32_t sequence{};  //!< Sequence number (wraps around)
+    uint32_t length{};    //!< Length of the state
+};
+
+//! @brief CRC-32 (IEEE 802.3) without the final XOR, bitwise since it runs only on load/save
+inline uint32_t crc32(const uint8_t* p, size_t len, uint32_t crc = 0xFFFFFFFFU)
+{
+    while (len--) {
+        crc ^= *p++;
+        for (uint_fast8_t i = 0; i < 8; ++i) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return crc;
+}
+
+///@cond
+namespace detail {
+inline void put32(uint8_t* p, const uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+inline uint32_t get32(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint32_t checksum(const uint8_t* buf, const size_t capacity)
+{
+    return ~crc32(buf + HEADER_SIZE, capacity, crc32(buf, 12));
+}
+}  // namespace detail
+///@endcond
+
+/*!
+  @brief Write the header of the slot
+  @param[in,out] buf Slot (HEADER_SIZE + capacity), the state must be placed at HEADER_SIZE
+  @param capacity Size of the state area
+  @param h Header
+  @return True if successful, false if the length exceeds the capacity
+ */
+inline bool encode(uint8_t* buf, const size_t capacity, const Header& h)
+{
+    if (h.length > capacity) {
+        return false;
+    }
+    buf[0] = MAGIC0;
+    buf[1] = MAGIC1;
+    buf[2] = VERSION;
+    buf[3] = h.accuracy;
+    detail::put32(buf + 4, h.sequence);
+    detail::put32(buf + 8, h.length);
+    detail::put32(buf + 12, detail::checksum(buf, capacity));
+    return true;
+}
+
+/*!
+  @brief Verify and read the header of the slot
+  @param buf Slot (HEADER_SIZE + capacity)
+  @param capacity Size of the state area
+  @param[out] h Header
+  @return True if valid
+ */
+inline bool decode(const uint8_t* buf, const size_t capacity, Header& h)
+{
+    if (buf[0] != MAGIC0 || buf[1] != MAGIC1 || buf[2] != VERSION || detail::get32(buf + 8) > capacity ||
+        detail::get32(buf + 12) != detail::checksum(buf, capacity)) {
+        return false;
+    }
+    h.accuracy = buf[3];
+    h.sequence = detail::get32(buf + 4);
+    h.length   = detail::get32(buf + 8);
+    return true;
+}
+
+//! @brief Is the sequence a newer than b? (wrap around aware)
+inline bool newer(const uint32_t a, const uint32_t b)
+{
+    return (int32_t)(a - b) > 0;
+}
+
+/*!
+  @brief Select the newest valid slot of the two
+  @return Index of the slot, -1 if neither is valid
+ */
+inline int select(const bool valid0, const uint32_t seq0, const bool valid1, const uint32_t seq1)
+{
+    if (valid1 && (!valid0 || newer(seq1, seq0))) {
+        return 1;
+    }
+    return valid0 ? 0 : -1;
+}
+
+}  // namespace state_slot
+}  // namespace bme688
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file deadband.hpp
+  @brief Change detection of the measured values by deadband and heartbeat
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+*/
+#ifndef M5_UNIT_ENV_DEADBAND_HPP
+#define M5_UNIT_ENV_DEADBAND_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <array>
+
+namespace m5 {
+namespace unit {
+namespace deadband {
+
+/*!
+  @class Deadband
+  @brief Decide whether the sample is worth reporting
+  @tparam E Enum of the fields
+  @tparam N Number of the fields
+  @details The sample is changed if any field moves beyond its threshold from the last changed sample,
+  or the heartbeat expires since the last changed sample. NaN to/from a value is a change
+  @note The first sample after reset is always changed
+  @note The units have it if UNIT_ENV_USING_DATA_PROCESSING is defined (ProcessingAdapter)
+  @code
+  m5::unit::sht30::Deadband::config_t cfg{};
+  cfg[m5::unit::sht30::Field::Temperature] = 0.1f;
+  cfg[m5::unit::sht30::Field::Humidity]    = 0.5f;
+  cfg.heartbeat                            = 60 * 1000;
+  unit.deadband(cfg);
+  unit.enableDeadband();
+  @endcode
+ */
+template <typename E, size_t N>
+class Deadband {
+public:
+    using values_t = std::array<float, N>;
+
+    /*!
+      @struct config_t
+      @brief Settings for change detection
+     */
+    struct config_t {
+        //! Threshold of each field (0: Any change, negative: The field is ignored)
+        std::array<float, N> threshold{};
+        //! Maximum silence (ms), the sample is changed if exceeded (0: No heartbeat)
+        uint32_t heartbeat{};
+
+        //! @brief Threshold of the field
+        inline float& operator[](const E field)
+        {
+            return threshold[static_cast<size_t>(field)];
+        }
+        //! @brief Threshold of the field
+        inline float operator[](const E field) const
+        {
+            return threshold[static_cast<size_t>(field)];
+        }
+    };
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration */
+    inline const config_t& config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configuration (and reset)
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+        reset();
+    }
+    ///@}
+
+    /*!
+      @brief Check the sample
+      @param values Values of the fields
+      @param at Time of the sample (ms)
+      @return True if changed
+     */
+    bool check(const values_t& values, const uint32_t at)
+    {
+        ++_samples;
+        bool changed = !_reported || (_cfg.heartbeat && at - _reported_at >= _cfg.heartbeat);
+        _heartbeats += (changed && _reported);
+        for (size_t i = 0; !changed && i < N; ++i) {
+            changed = moved(values[i], _reference[i], _cfg.threshold[i]);
+        }
+        if (changed) {
+            ++_changes;
+            _reference   = values;
+            _reported_at = at;
+            _reported    = true;
+        }
+        return changed;
+    }
+
+    //! @brief Forget the last changed sample and the counters
+    inline void reset()
+    {
+        _reported = false;
+        _samples  = _changes = _heartbeats = 0;
+    }
+
+    ///@name Report
+    ///@{
+    //! @brief Number of the checked samples
+    inline uint32_t samples() const
+    {
+        return _samples;
+    }
+    //! @brief Number of the changed samples
+    inline uint32_t changes() const
+    {
+        return _changes;
+    }
+    //! @brief Number of the changed samples by the heartbeat
+    inline uint32_t heartbeats() const
+    {
+        return _heartbeats;
+    }
+    //! @brief Ratio of the suppressed samples (0.0 - 1.0)
+    inline float suppression() const
+    {
+        return _samples ? (float)(_samples - _changes) / _samples : 0.0f;
+    }
+    ///@}
+
+protected:
+    static bool moved(const float v, const float ref, const float threshold)
+    {
+        if (threshold < 0.0f) {
+            return false;
+        }
+        if (std::isnan(v) || std::isnan(ref)) {
+            return std::isnan(v) != std::isnan(ref);
+        }
+        return threshold > 0.0f ? std::fabs(v - ref) > threshold : v != ref;
+    }
+
+private:
+    config_t _cfg{};
+    values_t _reference{};
+    uint32_t _reported_at{};
+    uint32_t _samples{}, _changes{}, _heartbeats{};
+    bool _reported{};
+};
+
+}  // namespace deadband
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,265 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file filter_pipeline.hpp
+  @brief Software filters for the measured values
+  @details Median-of-N, first-order IIR and scalar Kalman filter composable in fixed memory
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+*/
+#ifndef M5_UNIT_ENV_FILTER_PIPELINE_HPP
+#define M5_UNIT_ENV_FILTER_PIPELINE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <array>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace filter {
+
+constexpr uint8_t MAX_STAGES{3};  //!< Maximum number of the stages in a chain
+constexpr uint8_t MAX_WINDOW{9};  //!< Maximum window of the median filter
+
+/*!
+  @enum Type
+  @brief Type of the filter stage
+ */
+enum class Type : uint8_t {
+    None,    //!< Pass through
+    Median,  //!< Median of the latest N samples (spike removal)
+    IIR,     //!< First-order IIR (exponential smoothing)
+    Kalman,  //!< Scalar Kalman filter for the random walk
+};
+
+/*!
+  @struct Stage
+  @brief Settings of the filter stage
+ */
+struct Stage {
+    Type type{Type::None};  //!< Type
+    uint8_t window{};       //!< Window for Median (odd, 1 - MAX_WINDOW)
+    float a{};              //!< Smoothing factor for IIR (0.0 - 1.0), process noise variance for Kalman
+    float b{};              //!< Measurement noise variance for Kalman
+
+    //! @brief Median of the latest window samples
+    static Stage median(const uint8_t window)
+    {
+        Stage s{};
+        s.type   = Type::Median;
+        s.window = window < 1 ? 1 : (window > MAX_WINDOW ? MAX_WINDOW : window) | 1;
+        return s;
+    }
+    //! @brief y += alpha * (x - y)
+    static Stage iir(const float alpha)
+    {
+        Stage s{};
+        s.type = Type::IIR;
+        s.a    = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+        return s;
+    }
+    /*!
+      @brief Kalman filter
+      @param q Process noise variance (How fast the true value moves)
+      @param r Measurement noise variance (Square of the sensor noise)
+     */
+    static Stage kalman(const float q, const float r)
+    {
+        Stage s{};
+        s.type = Type::Kalman;
+        s.a    = q > 0.0f ? q : 0.0f;
+        s.b    = r > 0.0f ? r : std::numeric_limits<float>::min();
+        return s;
+    }
+};
+
+/*!
+  @class Chain
+  @brief Filter stages applied in order to a scalar
+  @note Not finite values pass through without touching the state
+  @code
+  m5::unit::filter::Chain::config_t cfg{{m5::unit::filter::Stage::median(5), m5::unit::filter::Stage::iir(0.2f)}};
+  @endcode
+ */
+class Chain {
+public:
+    //! @brief Stages in order, Type::None is skipped
+    using config_t = std::array<Stage, MAX_STAGES>;
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration */
+    inline const config_t& config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configuration (and reset)
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+        reset();
+    }
+    ///@}
+
+    //! @brief Any stage?
+    inline bool enabled() const
+    {
+        for (auto&& s : _cfg) {
+            if (s.type != Type::None) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! @brief Apply the stages
+    float apply(float v)
+    {
+        if (!std::isfinite(v)) {
+            return v;
+        }
+        for (uint_fast8_t i = 0; i < MAX_STAGES; ++i) {
+            v = apply(_cfg[i], _state[i], v);
+        }
+        return v;
+    }
+
+    //! @brief Reset the state
+    inline void reset()
+    {
+        _state = {};
+    }
+
+protected:
+    struct State {
+        float buf[MAX_WINDOW]{};  // Ring for Median
+        float x{}, p{};           // Output for IIR, estimate and variance for Kalman
+        uint8_t count{}, head{};
+    };
+
+    static float apply(const Stage& s, State& st, const float v)
+    {
+        switch (s.type) {
+            case Type::Median:
+                return median(s, st, v);
+            case Type::IIR:
+                st.x     = st.count ? st.x + s.a * (v - st.x) : v;
+                st.count = 1;
+                return st.x;
+            case Type::Kalman:
+                if (!st.count) {
+                    st.x     = v;
+                    st.p     = s.b;
+                    st.count = 1;
+                    return v;
+                } else {
+                    const float p = st.p + s.a;
+                    const float k = p / (p + s.b);
+                    st.x          = st.x + k * (v - st.x);
+                    st.p          = (1.0f - k) * p;
+                    return st.x;
+                }
+            default:
+                return v;
+        }
+    }
+
+    static float median(const Stage& s, State& st, const float v)
+    {
+        const uint8_t window = s.window < 1 ? 1 : (s.window > MAX_WINDOW ? MAX_WINDOW : s.window);
+        st.buf[st.head]      = v;
+        st.head              = (st.head + 1) % window;
+        if (st.count < window) {
+            ++st.count;
+        }
+        // Insertion sort of the small window
+        float w[MAX_WINDOW];
+        for (uint_fast8_t i = 0; i < st.count; ++i) {
+            const float x  = st.buf[i];
+            uint_fast8_t j = i;
+            for (; j && w[j - 1] > x; --j) {
+                w[j] = w[j - 1];
+            }
+            w[j] = x;
+        }
+        return (st.count & 1) ? w[st.count >> 1] : 0.5f * (w[(st.count >> 1) - 1] + w[st.count >> 1]);
+    }
+
+private:
+    config_t _cfg{};
+    std::array<State, MAX_STAGES> _state{};
+};
+
+/*!
+  @class Pipeline
+  @brief Filter chain of each field of the measurement data
+  @tparam E Enum of the fields
+  @tparam N Number of the fields
+  @note The units have it if UNIT_ENV_USING_DATA_PROCESSING is defined (ProcessingAdapter)
+  @code
+  unit.filterPipeline(m5::unit::sht30::Field::Temperature,
+                      {{m5::unit::filter::Stage::median(5), m5::unit::filter::Stage::iir(0.2f)}});
+  unit.enableFilterPipeline();
+  @endcode
+ */
+template <typename E, size_t N>
+class Pipeline {
+public:
+    using values_t = std::array<float, N>;
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration of the field */
+    inline const Chain::config_t& config(const E field) const
+    {
+        return _chain[static_cast<size_t>(field)].config();
+    }
+    //! @brief Set the configuration of the field (and reset the field)
+    inline void config(const E field, const Chain::config_t& cfg)
+    {
+        _chain[static_cast<size_t>(field)].config(cfg);
+    }
+    ///@}
+
+    /*!
+      @brief Apply the chain of each field
+      @param values Raw values
+      @return Filtered values
+     */
+    values_t apply(const values_t& values)
+    {
+        values_t out{};
+        for (size_t i = 0; i < N; ++i) {
+            out[i] = _chain[i].apply(values[i]);
+        }
+        return out;
+    }
+
+    //! @brief Reset the state of all fields
+    inline void reset()
+    {
+        for (auto&& c : _chain) {
+            c.reset();
+        }
+    }
+
+    //! @brief Values that represent not filtered
+    static values_t invalid()
+    {
+        values_t v{};
+        v.fill(std::numeric_limits<float>::quiet_NaN());
+        return v;
+    }
+
+private:
+    std::array<Chain, N> _chain{};
+};
+
+}  // namespace filter
+}  // namespace unit
+}  // namespace m5
+#endif
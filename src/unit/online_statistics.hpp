@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file online_statistics.hpp
+  @brief Streaming statistics of the measured values
+  @details Mean and variance (Welford), min/max and EWMA updated in O(1) per sample
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+*/
+#ifndef M5_UNIT_ENV_ONLINE_STATISTICS_HPP
+#define M5_UNIT_ENV_ONLINE_STATISTICS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <array>
+#include <atomic>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace statistics {
+
+//! @brief Default smoothing factor of the EWMA
+constexpr float DEFAULT_ALPHA{0.1f};
+
+/*!
+  @struct Snapshot
+  @brief Statistics of a field at a moment
+  @note NaN if no sample
+ */
+struct Snapshot {
+    uint32_t count{};                                         //!< Number of the samples
+    float mean{std::numeric_limits<float>::quiet_NaN()};      //!< Mean
+    float variance{std::numeric_limits<float>::quiet_NaN()};  //!< Unbiased sample variance (0 if one sample)
+    float minimum{std::numeric_limits<float>::quiet_NaN()};   //!< Minimum
+    float maximum{std::numeric_limits<float>::quiet_NaN()};   //!< Maximum
+    float ewma{std::numeric_limits<float>::quiet_NaN()};      //!< Exponentially weighted moving average
+    //! @brief Standard deviation
+    inline float stddev() const
+    {
+        return std::sqrt(variance);
+    }
+};
+
+/*!
+  @class Accumulator
+  @brief Statistics of a scalar
+  @note Not finite values are ignored
+ */
+class Accumulator {
+public:
+    //! @brief Push the value
+    void push(const float v, const float alpha = DEFAULT_ALPHA)
+    {
+        if (!std::isfinite(v)) {
+            return;
+        }
+        if (!_count++) {
+            _mean = _min = _max = _ewma = v;
+            return;
+        }
+        // Welford (in double to keep the precision of the pressure in Pa)
+        const double delta = v - _mean;
+        _mean += delta / _count;
+        _m2 += delta * (v - _mean);
+        _min = v < _min ? v : _min;
+        _max = v > _max ? v : _max;
+        _ewma += alpha * (v - _ewma);
+    }
+    //! @brief Gets the snapshot
+    Snapshot snapshot() const
+    {
+        Snapshot s{};
+        s.count = _count;
+        if (_count) {
+            s.mean     = _mean;
+            s.variance = _count > 1 ? _m2 / (_count - 1) : 0.0f;
+            s.minimum  = _min;
+            s.maximum  = _max;
+            s.ewma     = _ewma;
+        }
+        return s;
+    }
+    //! @brief Reset
+    inline void reset()
+    {
+        *this = Accumulator{};
+    }
+
+private:
+    double _mean{}, _m2{};
+    float _min{}, _max{}, _ewma{};
+    uint32_t _count{};
+};
+
+/*!
+  @class Statistics
+  @brief Statistics of the scalar fields of the measurement data
+  @tparam E Enum of the fields
+  @tparam N Number of the fields
+  @details The producer (push, reset) never waits, snapshots can be taken from other tasks without lock.
+  The reader retries if the producer updated while copying (sequence lock)
+  @warning Only one producer, call push/reset/alpha in the same task
+ */
+template <typename E, size_t N>
+class Statistics {
+public:
+    using values_t    = std::array<float, N>;
+    using snapshots_t = std::array<Snapshot, N>;
+
+    ///@name Producer
+    ///@{
+    //! @brief Gets the smoothing factor of the EWMA
+    inline float alpha() const
+    {
+        return _alpha;
+    }
+    //! @brief Set the smoothing factor of the EWMA (0.0 - 1.0)
+    inline void alpha(const float a)
+    {
+        _alpha = a < 0.0f ? 0.0f : (a > 1.0f ? 1.0f : a);
+    }
+    //! @brief Push the values of the fields
+    void push(const values_t& values)
+    {
+        begin_write();
+        for (size_t i = 0; i < N; ++i) {
+            _acc[i].push(values[i], _alpha);
+        }
+        end_write();
+    }
+    //! @brief Reset
+    void reset()
+    {
+        begin_write();
+        for (auto&& a : _acc) {
+            a.reset();
+        }
+        end_write();
+    }
+    ///@}
+
+    ///@name Reader
+    ///@{
+    //! @brief Gets the snapshots of all fields taken at once
+    snapshots_t snapshot() const
+    {
+        std::array<Accumulator, N> copy;
+        read(copy);
+        snapshots_t s{};
+        for (size_t i = 0; i < N; ++i) {
+            s[i] = copy[i].snapshot();
+        }
+        return s;
+    }
+    //! @brief Gets the snapshot of the field
+    Snapshot snapshot(const E field) const
+    {
+        return snapshot()[static_cast<size_t>(field)];
+    }
+    //! @brief Number of the pushes and resets (to detect the update)
+    inline uint32_t sequence() const
+    {
+        return _seq.load(std::memory_order_acquire) >> 1;
+    }
+    ///@}
+
+private:
+    inline void begin_write()
+    {
+        _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    inline void end_write()
+    {
+        _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    void read(std::array<Accumulator, N>& out) const
+    {
+        uint32_t s{};
+        do {
+            do {
+                s = _seq.load(std::memory_order_acquire);
+            } while (s & 1);  // Writing
+            out = _acc;
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (_seq.load(std::memory_order_relaxed) != s);
+    }
+
+    std::array<Accumulator, N> _acc{};
+    std::atomic<uint32_t> _seq{};
+    float _alpha{DEFAULT_ALPHA};
+};
+
+}  // namespace statistics
+}  // namespace unit
+}  // namespace m5
+#endif
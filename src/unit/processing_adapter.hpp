@@ -0,0 +1,226 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file processing_adapter.hpp
+  @brief Statistics, deadband and filter pipeline of the measured values shared by the units
+  @details Only available if UNIT_ENV_USING_DATA_PROCESSING is defined.
+  Otherwise the units and their data carry no extra state
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+*/
+#ifndef M5_UNIT_ENV_PROCESSING_ADAPTER_HPP
+#define M5_UNIT_ENV_PROCESSING_ADAPTER_HPP
+
+#include "online_statistics.hpp"
+#include "deadband.hpp"
+#include "filter_pipeline.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace m5 {
+namespace unit {
+namespace processing {
+
+#if defined(UNIT_ENV_USING_DATA_PROCESSING) || defined(DOXYGEN_PROCESS)
+/*!
+  @struct Sample
+  @brief Per-sample state of the measurement data
+  @tparam E Enum of the fields
+  @tparam N Number of the fields
+ */
+template <typename E, size_t N>
+struct Sample {
+    //! Changed beyond the deadband or by the heartbeat (always true if the deadband is disabled)
+    bool changed{true};
+    //! Filtered values in the order of the fields (NaN if the filter pipeline is disabled)
+    typename filter::Pipeline<E, N>::values_t filtered = filter::Pipeline<E, N>::invalid();
+    //! @brief Filtered value of the field
+    inline float filtered_value(const E f) const
+    {
+        return filtered[static_cast<size_t>(f)];
+    }
+};
+#else
+template <typename E, size_t N>
+struct Sample {};
+#endif
+
+}  // namespace processing
+
+#if defined(UNIT_ENV_USING_DATA_PROCESSING) || defined(DOXYGEN_PROCESS)
+/*!
+  @class ProcessingAdapter
+  @brief Statistics, deadband and filter pipeline API of the unit
+  @tparam U Unit (updated/empty/latest/oldest/discard are used)
+  @tparam D Data of the unit, derived from processing::Sample<E, N> and has values()
+  @tparam E Enum of the fields
+  @tparam N Number of the fields
+  @details The unit calls preprocess before buffering the measured data and postprocess after it
+ */
+template <class U, class D, typename E, size_t N>
+class ProcessingAdapter {
+public:
+    using statistics_t = ::m5::unit::statistics::Statistics<E, N>;
+    using deadband_t   = ::m5::unit::deadband::Deadband<E, N>;
+    using filter_t     = ::m5::unit::filter::Pipeline<E, N>;
+
+    ///@name Statistics
+    ///@{
+    /*!
+      @brief Gets the statistics of the measured values
+      @note Snapshots can be taken from other tasks without lock
+     */
+    inline const statistics_t& statistics() const
+    {
+        return _statistics;
+    }
+    /*!
+      @brief Enable/Disable the statistics
+      @param enable Update the statistics each time the data is measured if true
+      @param alpha Smoothing factor of the EWMA
+      @note Call it in the same task as update
+     */
+    inline void enableStatistics(const bool enable = true, const float alpha = ::m5::unit::statistics::DEFAULT_ALPHA)
+    {
+        _enable_statistics = enable;
+        _statistics.alpha(alpha);
+    }
+    //! @brief Reset the statistics
+    inline void resetStatistics()
+    {
+        _statistics.reset();
+    }
+    ///@}
+
+    ///@name Deadband
+    ///@{
+    //! @brief Gets the deadband (settings and report of the suppression)
+    inline const deadband_t& deadband() const
+    {
+        return _deadband;
+    }
+    /*!
+      @brief Set the deadband settings
+      @note The report is reset
+     */
+    inline void deadband(const typename deadband_t::config_t& cfg)
+    {
+        _deadband.config(cfg);
+    }
+    /*!
+      @brief Enable/Disable the deadband
+      @details If enabled, changed of the measured data is decided by the deadband
+     */
+    inline void enableDeadband(const bool enable = true)
+    {
+        _enable_deadband = enable;
+        _deadband.reset();
+    }
+    //! @brief Is the latest measured data updated and changed?
+    inline bool changed() const
+    {
+        auto u = static_cast<const U*>(this);
+        return u->updated() && !u->empty() && u->latest().changed;
+    }
+    /*!
+      @brief Discard the unchanged data from the oldest
+      @return Number of the discarded data
+      @code
+      // Iterate only the changed data
+      while (unit.discardUnchanged(), !unit.empty()) {
+          auto d = unit.oldest();
+          unit.discard();
+      }
+      @endcode
+     */
+    inline size_t discardUnchanged()
+    {
+        auto u = static_cast<U*>(this);
+        size_t n{};
+        while (!u->empty() && !u->oldest().changed) {
+            u->discard();
+            ++n;
+        }
+        return n;
+    }
+    ///@}
+
+    ///@name Filter pipeline
+    ///@{
+    //! @brief Gets the filter pipeline
+    inline const filter_t& filterPipeline() const
+    {
+        return _filter;
+    }
+    /*!
+      @brief Set the filter stages of the field
+      @param field Field
+      @param cfg Stages applied in order
+      @note The state of the field is reset
+     */
+    inline void filterPipeline(const E field, const ::m5::unit::filter::Chain::config_t& cfg)
+    {
+        _filter.config(field, cfg);
+    }
+    /*!
+      @brief Enable/Disable the filter pipeline
+      @details If enabled, filtered of the measured data is filtered before buffering, the raw is kept
+     */
+    inline void enableFilterPipeline(const bool enable = true)
+    {
+        _enable_filter = enable;
+        _filter.reset();
+    }
+    ///@}
+
+protected:
+    /*!
+      @brief Filter and check the change of the data before buffering
+      @param d Data
+      @param at Time of the data (ms)
+      @param valid False if the values are not representative (not filtered and not changed)
+     */
+    void preprocess(D& d, const uint32_t at, const bool valid = true)
+    {
+        if (_enable_filter && valid) {
+            d.filtered = _filter.apply(d.values());
+        }
+        d.changed = !_enable_deadband || (valid && _deadband.check(d.values(), at));
+    }
+    /*!
+      @brief Update the statistics by the buffered data
+      @param d Data
+      @param valid False if the values are not representative (not counted)
+     */
+    void postprocess(const D& d, const bool valid = true)
+    {
+        if (_enable_statistics && valid) {
+            _statistics.push(d.values());
+        }
+    }
+
+private:
+    statistics_t _statistics{};
+    deadband_t _deadband{};
+    filter_t _filter{};
+    bool _enable_statistics{}, _enable_deadband{}, _enable_filter{};
+};
+#else
+template <class U, class D, typename E, size_t N>
+class ProcessingAdapter {
+protected:
+    inline void preprocess(D&, const uint32_t, const bool = true)
+    {
+    }
+    inline void postprocess(const D&, const bool = true)
+    {
+    }
+};
+#endif
+
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,33 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file scd4x_pressure_compensator.cpp
+  @brief Automatic ambient pressure compensation for SCD4x fed from a pressure unit
+*/
+#include "scd4x_pressure_compensator.hpp"
+#include <M5Utility.hpp>
+
+namespace m5 {
+namespace unit {
+namespace scd4x {
+
+bool PressureCompensator::feed(const float hPa)
+{
+    uint16_t p{};
+    if (!_gate.check(hPa, m5::utility::millis(), p)) {
+        return false;
+    }
+    const bool ok = _unit.writeAmbientPressure(p);
+    _gate.commit(ok, p, m5::utility::millis());
+    if (ok) {
+        M5_LIB_LOGD("Ambient pressure:%u hPa (suppressed:%u)", p, _gate.counter().suppressed());
+    }
+    return ok;
+}
+
+}  // namespace scd4x
+}  // namespace unit
+}  // namespace m5
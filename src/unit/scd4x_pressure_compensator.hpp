@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file scd4x_pressure_compensator.hpp
+  @brief Automatic ambient pressure compensation for SCD4x fed from a pressure unit
+*/
+#ifndef M5_UNIT_ENV_SCD4X_PRESSURE_COMPENSATOR_HPP
+#define M5_UNIT_ENV_SCD4X_PRESSURE_COMPENSATOR_HPP
+
+#include "unit_SCD40.hpp"
+#include "unit_BMP280.hpp"
+#include "unit_QMP6988.hpp"
+#include "unit_BME688.hpp"
+#include "scd4x_pressure_gate.hpp"
+
+namespace m5 {
+namespace unit {
+namespace scd4x {
+
+///@name Conversion to hPa
+///@{
+//! @brief Pressure of BMP280 data (hPa)
+inline float pressure_hPa(const bmp280::Data& d)
+{
+    return d.pressure() * 0.01f;
+}
+//! @brief Pressure of QMP6988 data (hPa)
+inline float pressure_hPa(const qmp6988::Data& d)
+{
+    return d.pressure() * 0.01f;
+}
+//! @brief Pressure of BME688 data (hPa)
+inline float pressure_hPa(const bme688::Data& d)
+{
+    return d.raw_pressure() * 0.01f;
+}
+///@}
+
+/*!
+  @class PressureCompensator
+  @brief Drives UnitSCD40::writeAmbientPressure from the stream of a pressure unit
+  @details Writes only when the pressure has moved by the hysteresis or more,
+  and never more often than the configured interval
+  @code
+  m5::unit::UnitCO2 co2;
+  m5::unit::UnitENVPro envpro;
+  m5::unit::scd4x::PressureCompensator comp(co2);
+  void loop() {
+      Units.update();
+      comp.update(envpro);  // Uses the latest sample if envpro was updated
+  }
+  @endcode
+ */
+class PressureCompensator {
+public:
+    using config_t = PressureGate::config_t;
+    using Counter  = PressureGate::Counter;
+
+    explicit PressureCompensator(UnitSCD40& unit) : _unit{unit}
+    {
+    }
+    PressureCompensator(UnitSCD40& unit, const config_t& cfg) : _unit{unit}, _gate{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration */
+    inline const config_t& config() const
+    {
+        return _gate.config();
+    }
+    //! @brief Set the configuration
+    inline void config(const config_t& cfg)
+    {
+        _gate.config(cfg);
+    }
+    ///@}
+
+    /*!
+      @brief Feed the pressure of the pressure unit if it was updated
+      @tparam U UnitBMP280, UnitQMP6988 or UnitBME688
+      @param pressure_unit Pressure unit
+      @return True if written to SCD4x
+     */
+    template <class U>
+    bool update(const U& pressure_unit)
+    {
+        return pressure_unit.updated() && !pressure_unit.empty() && feed(pressure_hPa(pressure_unit.latest()));
+    }
+
+    /*!
+      @brief Feed the pressure
+      @param hPa Pressure (hPa)
+      @return True if written to SCD4x
+      @sa PressureGate
+     */
+    bool feed(const float hPa);
+
+    //! @brief Gets the last written pressure (hPa), 0 if not written yet
+    inline uint16_t lastWritten() const
+    {
+        return _gate.lastWritten();
+    }
+    //! @brief Gets the statistics
+    inline const Counter& counter() const
+    {
+        return _gate.counter();
+    }
+    //! @brief Reset the statistics and force writing on the next feed
+    inline void reset()
+    {
+        _gate.reset();
+    }
+
+private:
+    UnitSCD40& _unit;
+    PressureGate _gate{};
+};
+
+}  // namespace scd4x
+}  // namespace unit
+}  // namespace m5
+#endif
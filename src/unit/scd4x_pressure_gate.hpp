@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file scd4x_pressure_gate.hpp
+  @brief Decision of writing the ambient pressure to SCD4x by range, hysteresis and interval
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+  @sa scd4x_pressure_compensator.hpp
+*/
+#ifndef M5_UNIT_ENV_SCD4X_PRESSURE_GATE_HPP
+#define M5_UNIT_ENV_SCD4X_PRESSURE_GATE_HPP
+
+#include <cstdint>
+#include <cmath>
+
+namespace m5 {
+namespace unit {
+namespace scd4x {
+
+///@name Range of set_ambient_pressure
+///@{
+constexpr uint16_t AMBIENT_PRESSURE_MIN{700};   //!< @brief Lower limit (hPa)
+constexpr uint16_t AMBIENT_PRESSURE_MAX{1200};  //!< @brief Upper limit (hPa)
+///@}
+
+/*!
+  @class PressureGate
+  @brief Decide whether the pressure is worth writing
+  @details The value must be within the SCD4x range, and after the first write it must move by the hysteresis
+  or more from the last written value and the interval must have elapsed since the last write.
+  A failed write does not update the last written value, so the next value is tried again
+ */
+class PressureGate {
+public:
+    /*!
+      @struct config_t
+      @brief Settings for compensation
+     */
+    struct config_t {
+        //! Minimum change (hPa) from the last written value required to write
+        uint16_t hysteresis{2};
+        //! Minimum interval (ms) between writes
+        uint32_t interval{60 * 1000U};
+    };
+
+    /*!
+      @struct Counter
+      @brief Statistics of the link
+     */
+    struct Counter {
+        uint32_t written{};       //!< @brief Number of successful writes
+        uint32_t hysteresis{};    //!< @brief Suppressed because the change was within the hysteresis
+        uint32_t rate_limited{};  //!< @brief Suppressed because the interval has not elapsed
+        uint32_t out_of_range{};  //!< @brief Suppressed because the value is outside the SCD4x range
+        uint32_t failed{};        //!< @brief Number of failed writes
+        //! @brief Total number of suppressed writes
+        inline uint32_t suppressed() const
+        {
+            return hysteresis + rate_limited + out_of_range;
+        }
+    };
+
+    PressureGate() = default;
+    explicit PressureGate(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration */
+    inline const config_t& config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configuration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Check the pressure
+      @param hPa Pressure (hPa)
+      @param at Current time (ms)
+      @param[out] p Pressure to write (hPa)
+      @return True if it should be written, then call commit with the result
+     */
+    bool check(const float hPa, const uint32_t at, uint16_t& p)
+    {
+        if (!(hPa >= AMBIENT_PRESSURE_MIN && hPa <= AMBIENT_PRESSURE_MAX)) {  // Also NaN
+            ++_counter.out_of_range;
+            return false;
+        }
+        p = static_cast<uint16_t>(std::lround(hPa));
+        // The first value is always written
+        if (_written) {
+            const uint16_t diff = (p > _written) ? p - _written : _written - p;
+            if (diff < _cfg.hysteresis) {
+                ++_counter.hysteresis;
+                return false;
+            }
+            if (at - _written_at < _cfg.interval) {
+                ++_counter.rate_limited;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*!
+      @brief Record the result of the write
+      @param ok True if written
+      @param p Written pressure (hPa)
+      @param at Time of the write (ms)
+     */
+    void commit(const bool ok, const uint16_t p, const uint32_t at)
+    {
+        if (!ok) {
+            ++_counter.failed;
+            return;
+        }
+        ++_counter.written;
+        _written    = p;
+        _written_at = at;
+    }
+
+    //! @brief Gets the last written pressure (hPa), 0 if not written yet
+    inline uint16_t lastWritten() const
+    {
+        return _written;
+    }
+    //! @brief Gets the statistics
+    inline const Counter& counter() const
+    {
+        return _counter;
+    }
+    //! @brief Reset the statistics and force writing on the next check
+    inline void reset()
+    {
+        _counter    = Counter{};
+        _written    = 0;
+        _written_at = 0;
+    }
+
+private:
+    config_t _cfg{};
+    Counter _counter{};
+    uint16_t _written{};
+    uint32_t _written_at{};
+};
+
+}  // namespace scd4x
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file sgp30_baseline_manager.cpp
+  @brief Persisting the IAQ baseline of SGP30 across reboots
+*/
+#include "sgp30_baseline_manager.hpp"
+#include <M5Utility.hpp>
+
+namespace {
+// Clock before this (2024-01-01) is regarded as not set
+constexpr uint32_t VALID_EPOCH{1704067200U};
+}  // namespace
+
+namespace m5 {
+namespace unit {
+namespace sgp30 {
+
+uint32_t BaselineManager::epoch()
+{
+    auto now = std::time(nullptr);
+    return (now >= (time_t)VALID_EPOCH) ? (uint32_t)now : 0;
+}
+
+bool BaselineManager::load(BaselineRecord& rec)
+{
+    uint8_t buf[BaselineRecord::SIZE]{};
+    if (!_storage.read(_cfg.key, buf, sizeof(buf))) {
+        M5_LIB_LOGI("No stored baseline");
+        return false;
+    }
+    if (!rec.decode(buf) || !rec.co2eq || !rec.tvoc) {
+        M5_LIB_LOGW("Broken baseline");
+        ++_counter.discarded;
+        return false;
+    }
+
+    auto now = epoch();
+    switch (age_of(rec, now, _cfg.max_age)) {
+        case Age::Unknown:
+            if (!_cfg.restore_unknown_age) {
+                M5_LIB_LOGW("Unknown age of the baseline");
+                ++_counter.discarded;
+                return false;
+            }
+            break;
+        case Age::Stale:
+            M5_LIB_LOGW("Stale baseline %u sec", now - rec.saved_at);
+            ++_counter.discarded;
+            return false;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool BaselineManager::begin(const uint16_t humidity, const uint32_t interval)
+{
+    if (_unit.inPeriodic()) {
+        _unit.stopPeriodicMeasurement();
+    }
+
+    BaselineRecord rec{};
+    _restored = load(rec);
+    // Baseline must be restored in the 15 seconds IAQ_INIT window
+    _started = _restored
+                   ? _unit.startPeriodicMeasurement(rec.co2eq, rec.tvoc, humidity, interval)
+                   : (_unit.startPeriodicMeasurement(interval) && (!humidity || _unit.writeAbsoluteHumidity(humidity)));
+    if (!_started) {
+        M5_LIB_LOGE("Failed to start");
+        _restored = false;
+        return false;
+    }
+    if (_restored) {
+        _record = rec;
+        M5_LIB_LOGI("Restored baseline %04X:%04X", rec.co2eq, rec.tvoc);
+    }
+    _operated_base = _restored ? rec.operated : 0;
+    _started_at = _snapshot_at = m5::utility::millis();
+    return true;
+}
+
+void BaselineManager::update()
+{
+    if (!_started || !_unit.canMeasurePeriodic()) {
+        return;
+    }
+    auto at = m5::utility::millis();
+    if (snapshot_due(_restored, _counter.saved, at - _started_at, at - _snapshot_at, _cfg.learning_period,
+                     _cfg.snapshot_interval)) {
+        _snapshot_at = at;
+        snapshot();
+    }
+}
+
+bool BaselineManager::snapshot()
+{
+    BaselineRecord rec{};
+    if (!_unit.readIaqBaseline(rec.co2eq, rec.tvoc) || !rec.co2eq || !rec.tvoc) {
+        M5_LIB_LOGE("Failed to read baseline");
+        ++_counter.failed;
+        return false;
+    }
+    rec.saved_at = epoch();
+    rec.operated = _operated_base + (m5::utility::millis() - _started_at) / 1000;
+    if (rec.operated > BaselineRecord::MAX_OPERATED) {
+        rec.operated = BaselineRecord::MAX_OPERATED;
+    }
+
+    uint8_t buf[BaselineRecord::SIZE]{};
+    rec.encode(buf);
+    if (!_storage.write(_cfg.key, buf, sizeof(buf))) {
+        M5_LIB_LOGE("Failed to write baseline");
+        ++_counter.failed;
+        return false;
+    }
+    _record = rec;
+    ++_counter.saved;
+    M5_LIB_LOGD("Saved baseline %04X:%04X", rec.co2eq, rec.tvoc);
+    return true;
+}
+
+}  // namespace sgp30
+}  // namespace unit
+}  // namespace m5
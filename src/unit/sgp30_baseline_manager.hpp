@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file sgp30_baseline_manager.hpp
+  @brief Persisting the IAQ baseline of SGP30 across reboots
+*/
+#ifndef M5_UNIT_ENV_SGP30_BASELINE_MANAGER_HPP
+#define M5_UNIT_ENV_SGP30_BASELINE_MANAGER_HPP
+
+#include "unit_SGP30.hpp"
+#include "blob_storage.hpp"
+#include "sgp30_baseline_record.hpp"
+#include <ctime>
+
+namespace m5 {
+namespace unit {
+namespace sgp30 {
+
+/*!
+  @class BaselineManager
+  @brief Snapshots the IAQ baseline to the storage and restores it on start
+  @details Follows the Sensirion rules for the baseline
+  - Restore in the 15 seconds IAQ_INIT window
+  - Without a restored baseline, the first snapshot is taken after 12 hours of operation
+  - A snapshot is taken every hour thereafter
+  - A baseline older than 7 days is discarded
+  @code
+  m5::unit::UnitTVOC tvoc;
+  m5::unit::PreferencesBlobStorage storage;
+  m5::unit::sgp30::BaselineManager manager(tvoc, storage);
+  void setup() {
+      auto cfg = tvoc.config();
+      cfg.start_periodic = false;
+      tvoc.config(cfg);
+      // add and begin UnitUnified
+      manager.begin();
+  }
+  void loop() {
+      Units.update();
+      manager.update();
+  }
+  @endcode
+  @warning The age of the baseline is judged by the system clock (time()), set it up (e.g. SNTP) before begin()
+ */
+class BaselineManager {
+public:
+    /*!
+      @struct config_t
+      @brief Settings for the manager
+     */
+    struct config_t {
+        //! Interval of snapshots (ms)
+        uint32_t snapshot_interval{60 * 60 * 1000U};
+        //! Operation time required before the first snapshot if not restored (ms)
+        uint32_t learning_period{12 * 60 * 60 * 1000U};
+        //! Maximum age of the baseline to be restored (seconds)
+        uint32_t max_age{7 * 24 * 60 * 60U};
+        //! Restore even if the age is unknown because the clock was not set?
+        bool restore_unknown_age{false};
+        //! Key of the storage
+        const char* key{"sgp30_bl"};
+    };
+
+    /*!
+      @struct Counter
+      @brief Statistics of the manager
+     */
+    struct Counter {
+        uint32_t saved{};      //!< @brief Number of successful snapshots
+        uint32_t failed{};     //!< @brief Number of failed snapshots
+        uint32_t discarded{};  //!< @brief Number of discarded records (broken or stale)
+    };
+
+    BaselineManager(UnitSGP30& unit, BlobStorage& storage) : _unit{unit}, _storage{storage}
+    {
+    }
+    BaselineManager(UnitSGP30& unit, BlobStorage& storage, const config_t& cfg)
+        : _unit{unit}, _storage{storage}, _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration */
+    inline const config_t& config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configuration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Start periodic measurement with the stored baseline if available
+      @param humidity absolute humidity (disable if zero)
+      @param interval Measurement Interval(ms)
+      @return True if periodic measurement started
+      @note Restarts the periodic measurement if already running
+     */
+    bool begin(const uint16_t humidity = 0, const uint32_t interval = 1000U);
+    /*!
+      @brief Take a snapshot when it is due
+      @note Call after UnitUnified::update()
+     */
+    void update();
+    /*!
+      @brief Take a snapshot now
+      @return True if successful
+      @warning Snapshot before the learning period has elapsed is not recommended
+     */
+    bool snapshot();
+
+    //! @brief Was the baseline restored on begin?
+    inline bool restored() const
+    {
+        return _restored;
+    }
+    //! @brief Gets the latest record restored or saved
+    inline const BaselineRecord& record() const
+    {
+        return _record;
+    }
+    //! @brief Gets the statistics
+    inline const Counter& counter() const
+    {
+        return _counter;
+    }
+
+protected:
+    bool load(BaselineRecord& rec);
+    static uint32_t epoch();
+
+private:
+    UnitSGP30& _unit;
+    BlobStorage& _storage;
+    config_t _cfg{};
+    Counter _counter{};
+    BaselineRecord _record{};
+    bool _started{}, _restored{};
+    uint32_t _operated_base{};  // Operation time carried over by the restored record (seconds)
+    types::elapsed_time_t _started_at{}, _snapshot_at{};
+};
+
+}  // namespace sgp30
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file sgp30_baseline_record.hpp
+  @brief Persisted IAQ baseline of SGP30 and the rules of restoring and snapshotting it
+  @details Record layout (little endian)
+  |Offset|Size|Content|
+  |---|---|---|
+  |0|2|MAGIC ('S', 'B')|
+  |2|1|VERSION|
+  |3|1|Reserved|
+  |4|2|Baseline for CO2eq|
+  |6|2|Baseline for TVOC|
+  |8|4|Saved time (epoch seconds)|
+  |12|3|Accumulated operation time (seconds)|
+  |15|1|CRC-8 (polynomial 0x31, init 0xFF, same as the Sensirion word CRC) of the bytes 0 - 14|
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+  @sa sgp30_baseline_manager.hpp
+*/
+#ifndef M5_UNIT_ENV_SGP30_BASELINE_RECORD_HPP
+#define M5_UNIT_ENV_SGP30_BASELINE_RECORD_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace m5 {
+namespace unit {
+namespace sgp30 {
+
+///@cond
+namespace detail {
+constexpr uint8_t MAGIC0{'S'};
+constexpr uint8_t MAGIC1{'B'};
+constexpr uint8_t VERSION{1};
+
+// CRC-8 (polynomial 0x31, init 0xFF), bitwise since it runs only on load/save
+inline uint8_t crc8(const uint8_t* p, size_t len)
+{
+    uint8_t crc{0xFF};
+    while (len--) {
+        crc ^= *p++;
+        for (uint_fast8_t i = 0; i < 8; ++i) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+inline void put16(uint8_t* p, const uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+inline void put32(uint8_t* p, const uint32_t v)
+{
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+inline uint16_t get16(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8);
+}
+inline uint32_t get32(const uint8_t* p)
+{
+    return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+}  // namespace detail
+///@endcond
+
+/*!
+  @struct BaselineRecord
+  @brief Persisted IAQ baseline
+ */
+struct BaselineRecord {
+    //! @brief Size of the serialized record
+    static constexpr size_t SIZE{16};
+    //! @brief Maximum operation time (seconds, 24bits, 194 days)
+    static constexpr uint32_t MAX_OPERATED{0x00FFFFFF};
+
+    uint16_t co2eq{};     //!< @brief Baseline for CO2eq
+    uint16_t tvoc{};      //!< @brief Baseline for TVOC
+    uint32_t saved_at{};  //!< @brief Saved time (epoch seconds), 0 if the clock was not set
+    uint32_t operated{};  //!< @brief Accumulated operation time of the baseline algorithm (seconds, 24bits)
+
+    //! @brief Serialize with magic, version and CRC
+    void encode(uint8_t buf[SIZE]) const
+    {
+        buf[0] = detail::MAGIC0;
+        buf[1] = detail::MAGIC1;
+        buf[2] = detail::VERSION;
+        buf[3] = 0;  // Reserved
+        detail::put16(buf + 4, co2eq);
+        detail::put16(buf + 6, tvoc);
+        detail::put32(buf + 8, saved_at);
+        // operated is stored as 24bits
+        detail::put16(buf + 12, operated & 0xFFFF);
+        buf[14]       = (operated >> 16) & 0xFF;
+        buf[SIZE - 1] = detail::crc8(buf, SIZE - 1);
+    }
+    //! @brief Deserialize and verify
+    bool decode(const uint8_t buf[SIZE])
+    {
+        if (buf[0] != detail::MAGIC0 || buf[1] != detail::MAGIC1 || buf[2] != detail::VERSION ||
+            detail::crc8(buf, SIZE - 1) != buf[SIZE - 1]) {
+            return false;
+        }
+        co2eq    = detail::get16(buf + 4);
+        tvoc     = detail::get16(buf + 6);
+        saved_at = detail::get32(buf + 8);
+        operated = detail::get16(buf + 12) | ((uint32_t)buf[14] << 16);
+        return true;
+    }
+};
+
+/*!
+  @enum Age
+  @brief Age of the record to be restored
+ */
+enum class Age : uint8_t {
+    Fresh,    //!< Within the maximum age
+    Unknown,  //!< The clock was not set on the save or now, or the saved time is in the future
+    Stale,    //!< Older than the maximum age
+};
+
+/*!
+  @brief Judge the age of the record
+  @param rec Record
+  @param now Current time (epoch seconds), 0 if the clock is not set
+  @param max_age Maximum age (seconds)
+ */
+inline Age age_of(const BaselineRecord& rec, const uint32_t now, const uint32_t max_age)
+{
+    if (!now || !rec.saved_at || now < rec.saved_at) {
+        return Age::Unknown;
+    }
+    return (now - rec.saved_at > max_age) ? Age::Stale : Age::Fresh;
+}
+
+/*!
+  @brief Is a snapshot due?
+  @param restored Was the baseline restored on start?
+  @param saved Number of the snapshots taken since the start
+  @param elapsed Time since the start (ms)
+  @param since_snapshot Time since the last snapshot or the start (ms)
+  @param learning_period Operation time required before the first snapshot if not restored (ms)
+  @param interval Interval of snapshots (ms)
+  @details Without a restored baseline, nothing within the learning period, and the first one right after it
+ */
+inline bool snapshot_due(const bool restored, const uint32_t saved, const uint32_t elapsed,
+                         const uint32_t since_snapshot, const uint32_t learning_period, const uint32_t interval)
+{
+    if (!restored && elapsed < learning_period) {
+        return false;
+    }
+    return since_snapshot >= interval || (!restored && !saved);
+}
+
+}  // namespace sgp30
+}  // namespace unit
+}  // namespace m5
+#endif
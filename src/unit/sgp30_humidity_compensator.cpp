@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file sgp30_humidity_compensator.cpp
+  @brief Automatic humidity compensation for SGP30 fed from a temperature and humidity unit
+*/
+#include "sgp30_humidity_compensator.hpp"
+#include <M5Utility.hpp>
+#include <cmath>
+
+namespace m5 {
+namespace unit {
+namespace sgp30 {
+
+bool HumidityCompensator::feed(const float celsius, const float rh)
+{
+    if (std::isnan(celsius) || std::isnan(rh)) {
+        ++_counter.failed;
+        return false;
+    }
+
+    const uint16_t raw = absolute_humidity_to_raw(absolute_humidity(celsius, rh));
+    // The first value is always written
+    if (_written) {
+        const uint16_t diff = (raw > _written) ? raw - _written : _written - raw;
+        if (diff < _cfg.threshold * 256.0f) {
+            ++_counter.suppressed;
+            return false;
+        }
+    }
+
+    if (!_unit.writeAbsoluteHumidity(raw)) {
+        ++_counter.failed;
+        return false;
+    }
+    ++_counter.written;
+    _written = raw;
+    M5_LIB_LOGD("Absolute humidity:%u/256 g/m^3 (suppressed:%u)", raw, _counter.suppressed);
+    return true;
+}
+
+void HumidityCompensator::reset()
+{
+    _counter = Counter{};
+    _written = 0;
+}
+
+}  // namespace sgp30
+}  // namespace unit
+}  // namespace m5
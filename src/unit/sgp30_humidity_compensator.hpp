@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file sgp30_humidity_compensator.hpp
+  @brief Automatic humidity compensation for SGP30 fed from a temperature and humidity unit
+*/
+#ifndef M5_UNIT_ENV_SGP30_HUMIDITY_COMPENSATOR_HPP
+#define M5_UNIT_ENV_SGP30_HUMIDITY_COMPENSATOR_HPP
+
+#include "unit_SGP30.hpp"
+#include "absolute_humidity.hpp"
+
+namespace m5 {
+namespace unit {
+namespace sgp30 {
+
+/*!
+  @class HumidityCompensator
+  @brief Drives UnitSGP30::writeAbsoluteHumidity from the stream of UnitSHT30/UnitSHT40
+  @details Converts temperature and relative humidity to absolute humidity with absolute_humidity()
+  and writes only when it has moved by the threshold or more
+  @code
+  m5::unit::UnitTVOC tvoc;
+  m5::unit::UnitSHT40 sht40;
+  m5::unit::sgp30::HumidityCompensator comp(tvoc);
+  void loop() {
+      Units.update();
+      comp.update(sht40);  // Uses the latest sample if sht40 was updated
+  }
+  @endcode
+ */
+class HumidityCompensator {
+public:
+    /*!
+      @struct config_t
+      @brief Settings for compensation
+     */
+    struct config_t {
+        //! Minimum change (g/m^3) from the last written value required to write
+        float threshold{0.5f};
+    };
+
+    /*!
+      @struct Counter
+      @brief Statistics of the link
+     */
+    struct Counter {
+        uint32_t written{};     //!< @brief Number of successful writes
+        uint32_t suppressed{};  //!< @brief Suppressed because the change was within the threshold
+        uint32_t failed{};      //!< @brief Number of failed writes
+        uint32_t skipped{};     //!< @brief Skipped samples affected by the heater of UnitSHT40
+    };
+
+    explicit HumidityCompensator(UnitSGP30& unit) : _unit{unit}
+    {
+    }
+    HumidityCompensator(UnitSGP30& unit, const config_t& cfg) : _unit{unit}, _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    /*! @brief Gets the configuration */
+    inline const config_t& config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configuration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Feed the temperature and humidity of the unit if it was updated
+      @tparam U UnitSHT30 or UnitSHT40
+      @param th_unit Temperature and humidity unit
+      @return True if written to SGP30
+      @note Samples affected by the heater of UnitSHT40 (raised temperature, lowered humidity) are skipped
+     */
+    template <class U>
+    bool update(const U& th_unit)
+    {
+        if (th_unit.updated() && !th_unit.empty()) {
+            auto d = th_unit.latest();
+            if (!compensable(d)) {
+                ++_counter.skipped;
+                return false;
+            }
+            return feed(d.celsius(), d.humidity());
+        }
+        return false;
+    }
+
+    /*!
+      @brief Feed the temperature and humidity
+      @param celsius Temperature (Celsius)
+      @param rh Relative humidity (%)
+      @return True if written to SGP30
+     */
+    bool feed(const float celsius, const float rh);
+
+    //! @brief Gets the last written absolute humidity (g/m^3), 0 if not written yet
+    inline float lastWritten() const
+    {
+        return _written / 256.0f;
+    }
+    //! @brief Gets the statistics
+    inline const Counter& counter() const
+    {
+        return _counter;
+    }
+    //! @brief Reset the statistics and force writing on the next feed
+    void reset();
+
+private:
+    UnitSGP30& _unit;
+    config_t _cfg{};
+    Counter _counter{};
+    uint16_t _written{};
+};
+
+}  // namespace sgp30
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file stream_encoder.hpp
+  @brief Payloads of the measurement data of each unit for stream_frame.hpp
+  @details Raw words without CRC for the units whose values are self-contained, compensated floats for the units
+  whose compensation needs the calibration on the device
+*/
+#ifndef M5_UNIT_ENV_STREAM_ENCODER_HPP
+#define M5_UNIT_ENV_STREAM_ENCODER_HPP
+
+#include "stream_frame.hpp"
+#include "unit_SHT30.hpp"
+#include "unit_SHT40.hpp"
+#include "unit_SCD40.hpp"
+#include "unit_SGP30.hpp"
+#include "unit_BMP280.hpp"
+#include "unit_QMP6988.hpp"
+#include "unit_BME688.hpp"
+
+namespace m5 {
+namespace unit {
+namespace stream {
+
+///@cond
+namespace detail {
+inline uint8_t pack_words(uint8_t* out, const uint8_t* raw, const uint8_t words)
+{
+    // Skip the CRC after each word
+    for (uint_fast8_t i = 0; i < words; ++i) {
+        out[i * 2]     = raw[i * 3];
+        out[i * 2 + 1] = raw[i * 3 + 1];
+    }
+    return words * 2;
+}
+
+inline uint8_t pack_floats(uint8_t* out, const float* f, const uint8_t num)
+{
+    std::memcpy(out, f, num * sizeof(float));
+    return num * sizeof(float);
+}
+}  // namespace detail
+///@endcond
+
+/*!
+  @struct Payload
+  @brief Payload of the measurement data
+  @tparam D Data type of the unit
+  @details Specialization has type and pack(out, d) that returns the length
+ */
+template <class D>
+struct Payload;
+
+///@cond
+template <>
+struct Payload<sht30::Data> {
+    static constexpr Type type{Type::SHT30};
+    static uint8_t pack(uint8_t* out, const sht30::Data& d)
+    {
+        return detail::pack_words(out, d.raw.data(), 2);
+    }
+};
+
+template <>
+struct Payload<sht40::Data> {
+    static constexpr Type type{Type::SHT40};
+    static uint8_t pack(uint8_t* out, const sht40::Data& d)
+    {
+        uint8_t len = detail::pack_words(out, d.raw.data(), 2);
+        out[len++]  = (d.heater ? 0x01 : 0x00) | (d.recovery ? 0x02 : 0x00);
+        return len;
+    }
+};
+
+template <>
+struct Payload<scd4x::Data> {
+    static constexpr Type type{Type::SCD4x};
+    static uint8_t pack(uint8_t* out, const scd4x::Data& d)
+    {
+        return detail::pack_words(out, d.raw.data(), 3);
+    }
+};
+
+template <>
+struct Payload<sgp30::Data> {
+    static constexpr Type type{Type::SGP30};
+    static uint8_t pack(uint8_t* out, const sgp30::Data& d)
+    {
+        return detail::pack_words(out, d.raw.data(), 2);
+    }
+};
+
+template <>
+struct Payload<bmp280::Data> {
+    static constexpr Type type{Type::BMP280};
+    static uint8_t pack(uint8_t* out, const bmp280::Data& d)
+    {
+        const float f[2] = {d.temperature(), d.pressure()};
+        return detail::pack_floats(out, f, 2);
+    }
+};
+
+template <>
+struct Payload<qmp6988::Data> {
+    static constexpr Type type{Type::QMP6988};
+    static uint8_t pack(uint8_t* out, const qmp6988::Data& d)
+    {
+        const float f[2] = {d.temperature(), d.pressure()};
+        return detail::pack_floats(out, f, 2);
+    }
+};
+
+template <>
+struct Payload<bme688::Data> {
+    static constexpr Type type{Type::BME688};
+    static uint8_t pack(uint8_t* out, const bme688::Data& d)
+    {
+        // Raw pressure is Pa also if BSEC2 is used
+        const float f[4] = {d.raw_temperature(), d.raw_pressure(), d.raw_humidity(), d.raw_gas()};
+        uint8_t len      = detail::pack_floats(out, f, 4);
+        out[len++]       = d.raw.gas_index;
+        out[len++]       = d.raw.meas_index;
+        out[len++]       = d.raw.status;
+        out[len++]       = d.profile;
+        return len;
+    }
+};
+///@endcond
+
+/*!
+  @brief Encode the measurement data
+  @tparam D Data type of the unit
+  @param enc Encoder
+  @param[out] buf Output buffer
+  @param cap Capacity of the buffer
+  @param id Unit id
+  @param timestamp Timestamp (ms)
+  @param d Data
+  @return Number of the bytes written, 0 if failed
+  @code
+  uint8_t buf[m5::unit::stream::TIME_FRAME_LENGTH + m5::unit::stream::MAX_FRAME_LENGTH];
+  m5::unit::stream::Encoder enc;
+  if (unit.updated()) {
+      auto len = m5::unit::stream::encode(enc, buf, sizeof(buf), 0, m5::utility::millis(), unit.latest());
+      Serial.write(buf, len);
+  }
+  @endcode
+ */
+template <class D>
+inline size_t encode(Encoder& enc, uint8_t* buf, const size_t cap, const uint8_t id, const uint32_t timestamp,
+                     const D& d)
+{
+    uint8_t payload[MAX_PAYLOAD];
+    const uint8_t len = Payload<D>::pack(payload, d);
+    return enc.encode(buf, cap, Payload<D>::type, id, timestamp, payload, len);
+}
+
+}  // namespace stream
+}  // namespace unit
+}  // namespace m5
+#endif
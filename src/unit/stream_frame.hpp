@@ -0,0 +1,440 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file stream_frame.hpp
+  @brief Compact binary frames to stream the measurement data over serial
+  @details Frame layout (little endian)
+  |Offset|Size|Content|
+  |---|---|---|
+  |0|1|SYNC (0xA5)|
+  |1|1|Type of the payload|
+  |2|1|Unit id given by the application|
+  |3|2|Lower 16 bits of the timestamp (ms)|
+  |5|1|Payload length (N)|
+  |6|N|Payload|
+  |6+N|1|CRC-8 (polynomial 0x31, init 0xFF) of the bytes 1 - 5+N|
+
+  A Type::Time frame carrying the absolute timestamp precedes the first frame and any frame 65.536 seconds or more
+  after the previous one. The decoder restores the timestamp as the delta modulo 2^16 from the latest one, so that
+  lost frames do not shift the following timestamps
+  @note Header only and no dependency on M5UnitUnified so that the decoder can be used on the host
+  @sa stream_encoder.hpp for the payloads of each unit
+*/
+#ifndef M5_UNIT_ENV_STREAM_FRAME_HPP
+#define M5_UNIT_ENV_STREAM_FRAME_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace stream {
+
+///@name Frame
+///@{
+constexpr uint8_t SYNC{0xA5};        //!< @brief Start of the frame
+constexpr uint8_t HEADER_LENGTH{6};  //!< @brief SYNC, type, id, timestamp(2), length
+constexpr uint8_t MAX_PAYLOAD{32};   //!< @brief Maximum payload length
+//! @brief Maximum frame length including CRC
+constexpr uint8_t MAX_FRAME_LENGTH{HEADER_LENGTH + MAX_PAYLOAD + 1};
+//! @brief Length of the Type::Time frame
+constexpr uint8_t TIME_FRAME_LENGTH{HEADER_LENGTH + 4 + 1};
+///@}
+
+/*!
+  @enum Type
+  @brief Type of the payload
+ */
+enum class Type : uint8_t {
+    Time,     //!< uint32 absolute timestamp (ms)
+    SHT30,    //!< Temperature and humidity words (big endian, as the raw data without CRC)
+    SHT40,    //!< Temperature and humidity words, flags (bit0:heater bit1:recovery)
+    SCD4x,    //!< CO2, temperature and humidity words
+    SGP30,    //!< CO2eq and TVOC words
+    BMP280,   //!< float temperature (Celsius), float pressure (Pa)
+    QMP6988,  //!< float temperature (Celsius), float pressure (Pa)
+    BME688,   //!< float temperature (Celsius), pressure (Pa), humidity (RH), gas resistance (Ohm),
+              //!< gas_index, meas_index, status, profile
+};
+
+///@cond
+namespace detail {
+// CRC-8 (polynomial 0x31) of every byte value
+constexpr uint8_t crc8_table[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E, 0x43, 0x72, 0x21,
+    0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D, 0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73,
+    0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8, 0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C,
+    0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB, 0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6, 0xD7,
+    0x40, 0x71, 0x22, 0x13, 0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61,
+    0x50, 0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95, 0xF8, 0xC9,
+    0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F, 0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6, 0x7A, 0x4B, 0x18, 0x29, 0xBE,
+    0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54, 0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE,
+    0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17, 0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27,
+    0x16, 0x81, 0xB0, 0xE3, 0xD2, 0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3,
+    0xA0, 0x91, 0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69, 0x04,
+    0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A, 0xC1, 0xF0, 0xA3, 0x92,
+    0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF, 0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24,
+    0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC,
+};
+
+inline uint8_t crc8(const uint8_t* data, const size_t len, uint8_t crc = 0xFF)
+{
+    for (size_t i = 0; i < len; ++i) {
+        crc = crc8_table[crc ^ data[i]];
+    }
+    return crc;
+}
+}  // namespace detail
+///@endcond
+
+/*!
+  @class Encoder
+  @brief Frame encoder
+  @note Keeps the timestamp of the previous frame, use one instance per link
+ */
+class Encoder {
+public:
+    /*!
+      @brief Encode the frame
+      @param[out] buf Output buffer
+      @param cap Capacity of the buffer (TIME_FRAME_LENGTH + MAX_FRAME_LENGTH is enough for any frame)
+      @param type Type of the payload
+      @param id Unit id
+      @param timestamp Timestamp (ms)
+      @param payload Payload
+      @param len Length of the payload (MAX_PAYLOAD max)
+      @return Number of the bytes written, 0 if failed
+      @note A Type::Time frame is written before if needed
+     */
+    size_t encode(uint8_t* buf, const size_t cap, const Type type, const uint8_t id, const uint32_t timestamp,
+                  const uint8_t* payload, const uint8_t len)
+    {
+        if (!buf || (len && !payload) || len > MAX_PAYLOAD) {
+            return 0;
+        }
+        const bool sync = !_synced || (timestamp - _latest) > 0xFFFF;
+        if (cap < (sync ? TIME_FRAME_LENGTH : 0U) + HEADER_LENGTH + len + 1U) {
+            return 0;
+        }
+        size_t sz{};
+        if (sync) {
+            const uint8_t ts[4] = {(uint8_t)timestamp, (uint8_t)(timestamp >> 8), (uint8_t)(timestamp >> 16),
+                                   (uint8_t)(timestamp >> 24)};
+            sz      = frame(buf, cap, Type::Time, id, timestamp & 0xFFFF, ts, sizeof(ts));
+            _synced = true;
+            _latest = timestamp;
+        }
+        sz += frame(buf + sz, cap - sz, type, id, timestamp & 0xFFFF, payload, len);
+        _latest = timestamp;
+        return sz;
+    }
+
+    //! @brief Forget the previous timestamp (the next frame is preceded by Type::Time)
+    inline void reset()
+    {
+        _synced = false;
+    }
+
+    /*!
+      @brief Write a single frame as is
+      @return Number of the bytes written, 0 if failed
+     */
+    static size_t frame(uint8_t* buf, const size_t cap, const Type type, const uint8_t id, const uint16_t ts16,
+                        const uint8_t* payload, const uint8_t len)
+    {
+        const size_t sz = HEADER_LENGTH + len + 1;
+        if (cap < sz) {
+            return 0;
+        }
+        buf[0] = SYNC;
+        buf[1] = static_cast<uint8_t>(type);
+        buf[2] = id;
+        buf[3] = ts16 & 0xFF;
+        buf[4] = ts16 >> 8;
+        buf[5] = len;
+        if (len) {
+            std::memcpy(buf + HEADER_LENGTH, payload, len);
+        }
+        buf[sz - 1] = detail::crc8(buf + 1, sz - 2);
+        return sz;
+    }
+
+private:
+    uint32_t _latest{};
+    bool _synced{};
+};
+
+/*!
+  @struct Sample
+  @brief Decoded frame
+ */
+struct Sample {
+    Type type{};                     //!< Type of the payload
+    uint8_t id{};                    //!< Unit id
+    uint32_t timestamp{};            //!< Restored timestamp (ms)
+    uint8_t length{};                //!< Payload length
+    uint8_t payload[MAX_PAYLOAD]{};  //!< Payload
+
+    //! @brief Big endian word at the index
+    inline uint16_t word(const uint8_t idx) const
+    {
+        return ((uint16_t)payload[idx * 2] << 8) | payload[idx * 2 + 1];
+    }
+    //! @brief Little endian float at the index
+    inline float f32(const uint8_t idx) const
+    {
+        float f{};
+        std::memcpy(&f, payload + idx * 4, sizeof(f));
+        return f;
+    }
+
+    ///@name Values
+    ///@{
+    //! @brief Temperature (Celsius), NaN if not included
+    float temperature() const
+    {
+        switch (type) {
+            case Type::SHT30:
+            case Type::SHT40:
+                return -45 + word(0) * 175 / 65535.f;
+            case Type::SCD4x:
+                return -45 + word(1) * 175.f / 65536.f;
+            case Type::BMP280:
+            case Type::QMP6988:
+            case Type::BME688:
+                return f32(0);
+            default:
+                return std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    //! @brief Relative humidity (%RH), NaN if not included
+    float humidity() const
+    {
+        switch (type) {
+            case Type::SHT30:
+                return 100.f * word(1) / 65536.f;
+            case Type::SHT40:
+                return -6 + 125 * word(1) / 65535.f;
+            case Type::SCD4x:
+                return 100.f * word(2) / 65536.f;
+            case Type::BME688:
+                return f32(2);
+            default:
+                return std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    //! @brief Pressure (Pa), NaN if not included
+    float pressure() const
+    {
+        switch (type) {
+            case Type::BMP280:
+            case Type::QMP6988:
+            case Type::BME688:
+                return f32(1);
+            default:
+                return std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    //! @brief CO2 (SCD4x) or CO2eq (SGP30) (ppm), 0 if not included
+    uint16_t co2() const
+    {
+        return (type == Type::SCD4x || type == Type::SGP30) ? word(0) : 0;
+    }
+    //! @brief TVOC (ppb), 0 if not included
+    uint16_t tvoc() const
+    {
+        return type == Type::SGP30 ? word(1) : 0;
+    }
+    //! @brief Gas resistance (Ohm), NaN if not included
+    float gas() const
+    {
+        return type == Type::BME688 ? f32(3) : std::numeric_limits<float>::quiet_NaN();
+    }
+    ///@}
+};
+
+/*!
+  @class Decoder
+  @brief Frame decoder
+  @details Finds the SYNC, verifies the length and the CRC, and resynchronizes on the following bytes if broken
+  @code
+  m5::unit::stream::Decoder dec;
+  dec.decode(buf, len, [](const m5::unit::stream::Sample& s) {
+      printf("%u:%u %f\n", s.id, s.timestamp, s.temperature());
+  });
+  @endcode
+ */
+class Decoder {
+public:
+    /*!
+      @brief Push a byte
+      @return True if a frame is completed, then sample() is valid
+      @note Type::Time frames only update the timestamp and are not reported
+      @note Frames recovered from the bytes replayed by the resynchronization are reported on the following pushes,
+      decode() reports them at once
+     */
+    bool push(const uint8_t b)
+    {
+        if (!_pending) {
+            return step(b) || drain();
+        }
+        // Replayed bytes come before the new one
+        _replay[_pending++] = b;
+        return drain();
+    }
+
+    /*!
+      @brief Decode the bytes
+      @param buf Bytes
+      @param len Length
+      @param func Called with const Sample& for each completed frame
+      @return Number of the samples
+     */
+    template <class F>
+    size_t decode(const uint8_t* buf, const size_t len, F func)
+    {
+        size_t cnt{};
+        for (size_t i = 0; i < len; ++i) {
+            if (push(buf[i])) {
+                do {
+                    func(_sample);
+                    ++cnt;
+                } while (drain());
+            }
+        }
+        return cnt;
+    }
+
+    //! @brief Latest decoded sample
+    inline const Sample& sample() const
+    {
+        return _sample;
+    }
+
+    ///@name Statistics
+    ///@{
+    //! @brief Number of the frames decoded (including Type::Time)
+    inline uint32_t frames() const
+    {
+        return _frames;
+    }
+    //! @brief Number of the frames with the wrong CRC
+    inline uint32_t errors() const
+    {
+        return _errors;
+    }
+    //! @brief Number of the bytes skipped to find the SYNC
+    inline uint32_t dropped() const
+    {
+        return _dropped;
+    }
+    //! @brief Number of the frames received before any Type::Time (timestamp unknown)
+    inline uint32_t unsynced() const
+    {
+        return _unsynced;
+    }
+    ///@}
+
+    //! @brief Reset the state and the statistics
+    inline void reset()
+    {
+        *this = Decoder{};
+    }
+
+private:
+    bool accept()
+    {
+        ++_frames;
+        const Type type      = static_cast<Type>(_buf[1]);
+        const uint16_t ts16  = _buf[3] | ((uint16_t)_buf[4] << 8);
+        const uint8_t len    = _buf[5];
+        if (type == Type::Time) {
+            if (len == 4) {
+                _timestamp = _buf[6] | ((uint32_t)_buf[7] << 8) | ((uint32_t)_buf[8] << 16) | ((uint32_t)_buf[9] << 24);
+                _synced    = true;
+            }
+            return false;
+        }
+        _unsynced += !_synced;
+        _timestamp += (uint16_t)(ts16 - (_timestamp & 0xFFFF));
+        _sample.type      = type;
+        _sample.id        = _buf[2];
+        _sample.timestamp = _timestamp;
+        _sample.length    = len;
+        std::memcpy(_sample.payload, _buf + HEADER_LENGTH, len);
+        return true;
+    }
+
+    bool step(const uint8_t b)
+    {
+        if (!_pos && b != SYNC) {
+            ++_dropped;
+            return false;
+        }
+        _buf[_pos++] = b;
+        if (_pos == HEADER_LENGTH && _buf[5] > MAX_PAYLOAD) {
+            resync();
+            return false;
+        }
+        if (_pos < HEADER_LENGTH || _pos < (size_t)HEADER_LENGTH + _buf[5] + 1) {
+            return false;
+        }
+        // Completed
+        if (detail::crc8(_buf + 1, _pos - 2) != _buf[_pos - 1]) {
+            ++_errors;
+            resync();
+            return false;
+        }
+        _pos = 0;
+        return accept();
+    }
+
+    // Step the replayed bytes until a frame is completed
+    bool drain()
+    {
+        while (_head < _pending) {
+            if (step(_replay[_head++])) {
+                _pending -= _head;
+                std::memmove(_replay, _replay + _head, _pending);
+                _head = 0;
+                return true;
+            }
+        }
+        _head = _pending = 0;
+        return false;
+    }
+
+    // Retry from the next SYNC, the received bytes after the broken SYNC are replayed before the rest
+    // The replayed and the buffered bytes never exceed MAX_FRAME_LENGTH in total
+    void resync()
+    {
+        const size_t n    = _pos - 1;
+        const size_t rest = _pending - _head;
+        std::memmove(_replay + n, _replay + _head, rest);
+        std::memcpy(_replay, _buf + 1, n);
+        _head    = 0;
+        _pending = n + rest;
+        _pos     = 0;
+        ++_dropped;
+    }
+
+    uint8_t _buf[MAX_FRAME_LENGTH]{};
+    size_t _pos{};
+    uint8_t _replay[MAX_FRAME_LENGTH]{};
+    size_t _head{}, _pending{};
+    Sample _sample{};
+    uint32_t _timestamp{};
+    bool _synced{};
+    uint32_t _frames{}, _errors{}, _dropped{}, _unsynced{};
+};
+
+}  // namespace stream
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,193 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file text_fields.hpp
+  @brief Fields of the measurement data of each unit for text_formatter.hpp
+*/
+#ifndef M5_UNIT_ENV_TEXT_FIELDS_HPP
+#define M5_UNIT_ENV_TEXT_FIELDS_HPP
+
+#include "text_formatter.hpp"
+#include "unit_SHT30.hpp"
+#include "unit_SHT40.hpp"
+#include "unit_SCD40.hpp"
+#include "unit_SGP30.hpp"
+#include "unit_BMP280.hpp"
+#include "unit_QMP6988.hpp"
+#include "unit_BME688.hpp"
+
+namespace m5 {
+namespace unit {
+namespace text {
+
+/*!
+  @struct Fields
+  @brief Fields of the measurement data
+  @tparam D Data type of the unit
+  @details Specialization has name and write(w, d) that calls w.field(name, d, getter, decimals) for each field
+ */
+template <class D>
+struct Fields;
+
+///@cond
+template <>
+struct Fields<sht30::Data> {
+    static constexpr const char* name{"sht30"};
+    template <class W>
+    static void write(W& w, const sht30::Data& d)
+    {
+        w.field("temperature", d, &sht30::Data::celsius, 2).field("humidity", d, &sht30::Data::humidity, 2);
+    }
+};
+
+template <>
+struct Fields<sht40::Data> {
+    static constexpr const char* name{"sht40"};
+    template <class W>
+    static void write(W& w, const sht40::Data& d)
+    {
+        w.field("temperature", d, &sht40::Data::celsius, 2).field("humidity", d, &sht40::Data::humidity, 2);
+    }
+};
+
+template <>
+struct Fields<scd4x::Data> {
+    static constexpr const char* name{"scd4x"};
+    template <class W>
+    static void write(W& w, const scd4x::Data& d)
+    {
+        w.field("co2", d, &scd4x::Data::co2)
+            .field("temperature", d, &scd4x::Data::celsius, 2)
+            .field("humidity", d, &scd4x::Data::humidity, 2);
+    }
+};
+
+template <>
+struct Fields<sgp30::Data> {
+    static constexpr const char* name{"sgp30"};
+    template <class W>
+    static void write(W& w, const sgp30::Data& d)
+    {
+        w.field("co2eq", d, &sgp30::Data::co2eq).field("tvoc", d, &sgp30::Data::tvoc);
+    }
+};
+
+template <>
+struct Fields<bmp280::Data> {
+    static constexpr const char* name{"bmp280"};
+    template <class W>
+    static void write(W& w, const bmp280::Data& d)
+    {
+        w.field("temperature", d, &bmp280::Data::celsius, 2).field("pressure", d, &bmp280::Data::pressure, 1);
+    }
+};
+
+template <>
+struct Fields<qmp6988::Data> {
+    static constexpr const char* name{"qmp6988"};
+    template <class W>
+    static void write(W& w, const qmp6988::Data& d)
+    {
+        w.field("temperature", d, &qmp6988::Data::celsius, 2).field("pressure", d, &qmp6988::Data::pressure, 1);
+    }
+};
+
+template <>
+struct Fields<bme688::Data> {
+    static constexpr const char* name{"bme688"};
+    template <class W>
+    static void write(W& w, const bme688::Data& d)
+    {
+#if defined(UNIT_BME688_USING_BSEC2)
+        w.field("iaq", d, &bme688::Data::iaq, 1)
+            .field("iaq_accuracy", d, &bme688::Data::iaq_accuracy)
+            .field("co2", d, &bme688::Data::co2, 1)
+            .field("voc", d, &bme688::Data::voc, 2);
+#endif
+        // Raw pressure is Pa also if BSEC2 is used (BSEC2 raw pressure output is hPa)
+        w.field("temperature", d, &bme688::Data::raw_temperature, 2)
+            .field("pressure", d, &bme688::Data::raw_pressure, 1)
+            .field("humidity", d, &bme688::Data::raw_humidity, 2)
+            .field("gas", d, &bme688::Data::raw_gas, 0);
+    }
+};
+///@endcond
+
+/*!
+  @brief Write the CSV header
+  @tparam D Data type of the unit
+  @param f Formatter
+  @param timestamp Name of the leading timestamp column, no column if nullptr
+  @return True if all the output written
+ */
+template <class D>
+inline bool csv_header(Formatter& f, const char* timestamp = "timestamp")
+{
+    CsvHeader h(f);
+    if (timestamp) {
+        h.column(timestamp);
+    }
+    Fields<D>::write(h, D{});
+    h.end();
+    return f.ok();
+}
+
+/*!
+  @brief Write the measurement data as a CSV line
+  @tparam D Data type of the unit
+  @param f Formatter
+  @param timestamp Leading timestamp
+  @param d Data
+  @return True if all the output written
+  @note Appended to the text, so that the lines can be batched
+ */
+template <class D>
+inline bool csv(Formatter& f, const uint64_t timestamp, const D& d)
+{
+    CsvLine l(f);
+    l.column(timestamp);
+    Fields<D>::write(l, d);
+    l.end();
+    return f.ok();
+}
+
+/*!
+  @brief Write the measurement data as InfluxDB line protocol
+  @tparam D Data type of the unit
+  @param f Formatter
+  @param measurement Measurement name
+  @param timestamp Timestamp (The precision of the write request, e.g. ns)
+  @param d Data
+  @return True if all the output written, false if the buffer is full or no valid field (nothing is appended)
+  @note The unit tag is the name of the unit (e.g. unit=sht30)
+  @code
+  char buf[128];
+  m5::unit::text::Formatter f(buf, sizeof(buf));
+  if (unit.updated() && m5::unit::text::influx(f, "env", ts_ms, unit.latest())) {
+      client.write(f.c_str(), f.length());  // POST /api/v2/write?precision=ms
+  }
+  @endcode
+ */
+template <class D>
+inline bool influx(Formatter& f, const char* measurement, const uint64_t timestamp, const D& d)
+{
+    const size_t len = f.length();
+    InfluxLine l(f, measurement);
+    l.tag("unit", Fields<D>::name);
+    Fields<D>::write(l, d);
+    if (!l.count()) {
+        // A line without fields is rejected by the server
+        f.truncate(len);
+        return false;
+    }
+    l.end(timestamp);
+    return f.ok();
+}
+
+}  // namespace text
+}  // namespace unit
+}  // namespace m5
+#endif
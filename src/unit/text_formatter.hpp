@@ -0,0 +1,347 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file text_formatter.hpp
+  @brief Allocation-free text formatter for CSV and InfluxDB line protocol
+  @details Writes fixed-point decimal text directly into the caller buffer without heap and printf
+  @note Header only and no dependency on M5UnitUnified so that it can be tested on the host
+  @sa text_fields.hpp for the fields of each unit
+*/
+#ifndef M5_UNIT_ENV_TEXT_FORMATTER_HPP
+#define M5_UNIT_ENV_TEXT_FORMATTER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
+
+namespace m5 {
+namespace unit {
+namespace text {
+
+///@cond
+namespace detail {
+// Floating point getters are written as fixed-point, the others as integer
+template <typename R>
+using value_t = typename std::conditional<std::is_floating_point<R>::value, float, uint32_t>::type;
+}  // namespace detail
+///@endcond
+
+//! @brief Maximum number of decimals of Formatter::fixed
+constexpr uint8_t MAX_DECIMALS{6};
+
+/*!
+  @class Formatter
+  @brief Appends text to the fixed buffer
+  @details Always null-terminated, further output is ignored once the buffer is full
+ */
+class Formatter {
+public:
+    /*!
+      @param buf Output buffer
+      @param cap Capacity of the buffer including the null terminator
+     */
+    Formatter(char* buf, const size_t cap) : _buf{buf}, _cap{cap}
+    {
+        clear();
+    }
+
+    //! @brief Written text
+    inline const char* c_str() const
+    {
+        return _buf;
+    }
+    //! @brief Length of the written text
+    inline size_t length() const
+    {
+        return _len;
+    }
+    //! @brief Is all the output written? (false if the buffer was full)
+    inline bool ok() const
+    {
+        return !_overflow;
+    }
+    //! @brief Clear the text
+    inline void clear()
+    {
+        _len      = 0;
+        _overflow = !_buf || !_cap;
+        if (_buf && _cap) {
+            _buf[0] = '\0';
+        }
+    }
+    //! @brief Truncate the text to the length
+    inline void truncate(const size_t len)
+    {
+        if (len < _len) {
+            _len       = len;
+            _buf[_len] = '\0';
+        }
+    }
+
+    ///@name Output
+    ///@{
+    Formatter& character(const char c)
+    {
+        if (_len + 1 < _cap) {
+            _buf[_len++] = c;
+            _buf[_len]   = '\0';
+        } else {
+            _overflow = true;
+        }
+        return *this;
+    }
+    Formatter& text(const char* s)
+    {
+        while (s && *s) {
+            character(*s++);
+        }
+        return *this;
+    }
+    Formatter& uint(uint64_t v)
+    {
+        char tmp[20];
+        uint_fast8_t n{};
+        do {
+            tmp[n++] = '0' + (v % 10);
+            v /= 10;
+        } while (v);
+        while (n) {
+            character(tmp[--n]);
+        }
+        return *this;
+    }
+    Formatter& integer(const int64_t v)
+    {
+        if (v < 0) {
+            character('-');
+            return uint(0 - (uint64_t)v);
+        }
+        return uint(v);
+    }
+    /*!
+      @brief Fixed-point decimal
+      @param v Value
+      @param decimals Number of decimals (MAX_DECIMALS max), rounded half away from zero
+      @return True if written, false if the value is not finite or too large (nothing is written)
+     */
+    bool fixed(const float v, uint8_t decimals)
+    {
+        static constexpr uint32_t pow10[MAX_DECIMALS + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+        decimals = decimals > MAX_DECIMALS ? MAX_DECIMALS : decimals;
+        // The integer part must fit in uint32
+        if (!std::isfinite(v) || std::fabs(v) >= 4294967296.0f) {
+            return false;
+        }
+        // No double (software floating point on ESP32). The float is split into the 24 bits mantissa and the exponent,
+        // the integer part and the rounded fraction are computed exactly in integer (6 decimals fit in uint32)
+        const float a = std::fabs(v);
+        int e{};
+        const uint32_t mant = (uint32_t)std::ldexp(std::frexp(a, &e), 24);  // a = mant * 2^(e - 24)
+        const int shift     = 24 - e;
+        uint32_t ip{}, frac{};
+        if (shift <= 0) {
+            ip = mant << -shift;
+        } else {
+            ip = shift < 32 ? mant >> shift : 0;
+            if (shift < 48) {  // Rounded to 0 if more, fraction bits * 10^decimals < 2^44
+                const uint64_t fb = shift < 32 ? mant & ((1UL << shift) - 1) : mant;
+                frac              = (uint32_t)((fb * pow10[decimals] + (1ULL << (shift - 1))) >> shift);
+            }
+        }
+        if (frac >= pow10[decimals]) {
+            ++ip;
+            frac -= pow10[decimals];
+        }
+        if (v < 0 && (ip || frac)) {
+            character('-');
+        }
+        uint(ip);
+        if (decimals) {
+            character('.');
+            for (uint32_t d = pow10[decimals] / 10; d; d /= 10) {
+                character('0' + (frac / d) % 10);
+            }
+        }
+        return true;
+    }
+    ///@}
+
+private:
+    char* _buf{};
+    size_t _cap{};
+    size_t _len{};
+    bool _overflow{};
+};
+
+/*!
+  @class CsvHeader
+  @brief Writes the names of the fields as the CSV header
+ */
+class CsvHeader {
+public:
+    explicit CsvHeader(Formatter& f) : _f(f)
+    {
+    }
+    template <typename T>
+    CsvHeader& field(const char* name, const T, const uint8_t = 0)
+    {
+        separator();
+        _f.text(name);
+        return *this;
+    }
+    //! @brief The getter is not called
+    template <class D, typename R>
+    CsvHeader& field(const char* name, const D&, R (D::*)() const, const uint8_t = 0)
+    {
+        return field(name, 0);
+    }
+    //! @brief Leading column (e.g. the timestamp)
+    CsvHeader& column(const char* name)
+    {
+        separator();
+        _f.text(name);
+        return *this;
+    }
+    Formatter& end()
+    {
+        return _f.character('\n');
+    }
+
+private:
+    inline void separator()
+    {
+        if (_count++) {
+            _f.character(',');
+        }
+    }
+    Formatter& _f;
+    uint32_t _count{};
+};
+
+/*!
+  @class CsvLine
+  @brief Writes the values of the fields as a CSV line
+  @note Not finite values are written as empty
+ */
+class CsvLine {
+public:
+    explicit CsvLine(Formatter& f) : _f(f)
+    {
+    }
+    CsvLine& field(const char*, const float v, const uint8_t decimals)
+    {
+        separator();
+        _f.fixed(v, decimals);
+        return *this;
+    }
+    CsvLine& field(const char*, const uint32_t v, const uint8_t = 0)
+    {
+        separator();
+        _f.uint(v);
+        return *this;
+    }
+    template <class D, typename R>
+    CsvLine& field(const char* name, const D& d, R (D::*get)() const, const uint8_t decimals = 0)
+    {
+        return field(name, (detail::value_t<R>)(d.*get)(), decimals);
+    }
+    //! @brief Leading column (e.g. the timestamp)
+    CsvLine& column(const uint64_t v)
+    {
+        separator();
+        _f.uint(v);
+        return *this;
+    }
+    Formatter& end()
+    {
+        return _f.character('\n');
+    }
+
+private:
+    inline void separator()
+    {
+        if (_count++) {
+            _f.character(',');
+        }
+    }
+    Formatter& _f;
+    uint32_t _count{};
+};
+
+/*!
+  @class InfluxLine
+  @brief Writes InfluxDB line protocol
+  @details measurement[,tag=value...] field=value[,field=value...] [timestamp]
+  @note Not finite values are skipped, the caller must escape the names if needed
+  @code
+  char buf[128];
+  m5::unit::text::Formatter f(buf, sizeof(buf));
+  m5::unit::text::InfluxLine(f, "env").tag("unit", "sht30").field("temperature", 25.12f, 2).end(ts_ns);
+  @endcode
+ */
+class InfluxLine {
+public:
+    InfluxLine(Formatter& f, const char* measurement) : _f(f)
+    {
+        _f.text(measurement);
+    }
+    InfluxLine& tag(const char* key, const char* value)
+    {
+        _f.character(',').text(key).character('=').text(value);
+        return *this;
+    }
+    InfluxLine& field(const char* name, const float v, const uint8_t decimals)
+    {
+        const size_t len = _f.length();
+        separator();
+        _f.text(name).character('=');
+        if (!_f.fixed(v, decimals)) {
+            _f.truncate(len);
+            --_count;
+        }
+        return *this;
+    }
+    InfluxLine& field(const char* name, const uint32_t v, const uint8_t = 0)
+    {
+        separator();
+        _f.text(name).character('=').uint(v).character('i');
+        return *this;
+    }
+    template <class D, typename R>
+    InfluxLine& field(const char* name, const D& d, R (D::*get)() const, const uint8_t decimals = 0)
+    {
+        return field(name, (detail::value_t<R>)(d.*get)(), decimals);
+    }
+    //! @brief Number of the fields written
+    inline uint32_t count() const
+    {
+        return _count;
+    }
+    //! @brief End the line without the timestamp (the server time is used)
+    Formatter& end()
+    {
+        return _f.character('\n');
+    }
+    //! @brief End the line with the timestamp
+    Formatter& end(const uint64_t timestamp)
+    {
+        return _f.character(' ').uint(timestamp).character('\n');
+    }
+
+private:
+    inline void separator()
+    {
+        _f.character(_count++ ? ',' : ' ');
+    }
+    Formatter& _f;
+    uint32_t _count{};
+};
+
+}  // namespace text
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -8,15 +8,20 @@
   @brief BME688 Unit for M5UnitUnified
 */
 #include "unit_BME688.hpp"
+#include "bme688_field_decoder.hpp"
 #if defined(UNIT_BME688_USING_BSEC2)
 #pragma message "Using bsec2"
 #include <inc/bsec_interface.h>  // BSEC2
+#include <esp_timer.h>
 #else
 #pragma message "Not using bsec2"
 #endif
 #include <M5Utility.hpp>
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <mutex>
+#include <new>
 
 using namespace m5::utility::mmh3;
 using namespace m5::unit::types;
@@ -79,8 +84,40 @@ constexpr uint8_t default_config[BSEC_MAX_PROPERTY_BLOB_SIZE] = {
 constexpr uint32_t interval_table[] = {
     0, 3 * 1000, 300 * 1000, 300 * 1000, 18 * 1000, 1 * 1000,
 };
+
+// Work buffer for BSEC2 shared by all instances
+// It is only used transiently in bsec_set_configuration/bsec_get_configuration/bsec_set_state/bsec_get_state
+struct Bsec2Work {
+    std::mutex mutex{};
+    uint8_t* buffer{};
+    std::unique_ptr<uint8_t[]> owned{};  // Allocated on first use if the caller does not provide it
+};
+
+Bsec2Work& bsec2_work()
+{
+    static Bsec2Work work{};
+    return work;
+}
+
+// Must be called with the mutex locked
+uint8_t* acquire_bsec2_work()
+{
+    auto& w = bsec2_work();
+    if (!w.buffer) {
+        w.owned.reset(new (std::nothrow) uint8_t[BSEC_MAX_WORKBUFFER_SIZE]);
+        w.buffer = w.owned.get();
+        if (!w.buffer) {
+            M5_LIB_LOGE("Failed to allocate");
+        }
+    }
+    return w.buffer;
+}
 #endif
 
+// Polling of the new data in forced mode (Same as read_field_data in bme68x.c)
+constexpr uint32_t NEW_DATA_TRIES{5};
+constexpr uint32_t NEW_DATA_POLL_MS{10};
+
 void delay_us_function(uint32_t period, void* /*intf_ptr*/)
 {
     m5::utility::delayMicroseconds(period);
@@ -115,15 +152,46 @@ namespace unit {
 
 #if defined(UNIT_BME688_USING_BSEC2)
 namespace bme688 {
-float Data::get(const bsec_virtual_sensor_t vs) const
+void Data::store(const bsecOutputs& outputs)
 {
-    for (uint_fast8_t i = 0; i < raw_outputs.nOutputs; ++i) {
-        if (raw_outputs.output[i].sensor_id == vs) {
-            return raw_outputs.output[i].signal;
+#if defined(UNIT_BME688_BSEC2_RAW_OUTPUTS_MEMBER)
+    raw_outputs = outputs;
+#endif
+    mask       = 0;
+    accuracies = 0;
+    // Collect the bits first, since positions depend on all the stored sensors
+    for (uint_fast8_t i = 0; i < outputs.nOutputs; ++i) {
+        auto id = outputs.output[i].sensor_id;
+        if (id < 32 && __builtin_popcount(mask) < bsec2::MAX_OUTPUTS) {
+            mask |= 1U << id;
+        }
+    }
+    for (uint_fast8_t i = 0; i < outputs.nOutputs; ++i) {
+        auto vs = static_cast<bsec_virtual_sensor_t>(outputs.output[i].sensor_id);
+        if (exists(vs)) {
+            auto pos    = position(vs);
+            signal[pos] = outputs.output[i].signal;
+            accuracies |= static_cast<uint64_t>(outputs.output[i].accuracy & 0x03) << (pos * 2);
         }
     }
-    return std::numeric_limits<float>::quiet_NaN();
 }
+
+#if !defined(UNIT_BME688_BSEC2_RAW_OUTPUTS_MEMBER)
+bsecOutputs Data::raw_outputs() const
+{
+    bsecOutputs outputs{};
+    for (uint_fast8_t vs = 0; vs < 32; ++vs) {
+        if (exists(static_cast<bsec_virtual_sensor_t>(vs))) {
+            auto& o             = outputs.output[outputs.nOutputs++];
+            o.sensor_id         = vs;
+            o.signal            = get(static_cast<bsec_virtual_sensor_t>(vs));
+            o.signal_dimensions = 1;
+            o.accuracy          = accuracy(static_cast<bsec_virtual_sensor_t>(vs));
+        }
+    }
+    return outputs;
+}
+#endif
 }  // namespace bme688
 #endif
 
@@ -137,6 +205,7 @@ int8_t UnitBME688::read_function(uint8_t reg_addr, uint8_t* reg_data, uint32_t l
 {
     assert(intf_ptr);
     UnitBME688* unit = (UnitBME688*)intf_ptr;
+    ++unit->_transactions;
     return unit->readRegister(reg_addr, reg_data, length, 0) ? BME68X_OK : BME68X_E_COM_FAIL;
 }
 
@@ -144,6 +213,7 @@ int8_t UnitBME688::write_function(uint8_t reg_addr, const uint8_t* reg_data, uin
 {
     assert(intf_ptr);
     UnitBME688* unit = (UnitBME688*)intf_ptr;
+    ++unit->_transactions;
     return unit->writeRegister(reg_addr, reg_data, length) ? BME68X_OK : BME68X_E_COM_FAIL;
 }
 
@@ -156,11 +226,6 @@ UnitBME688::UnitBME688(const uint8_t addr) : Component(addr), _data{new m5::cont
     _dev.delay_us = delay_us_function;
     _dev.intf_ptr = this;
     _dev.amb_temp = 25;
-#if defined(UNIT_BME688_USING_BSEC2)
-    _bsec2_work.reset(new uint8_t[BSEC_MAX_WORKBUFFER_SIZE]);
-    assert(_bsec2_work);
-#endif
-
     auto ccfg  = component_config();
     ccfg.clock = 400 * 1000U;
     component_config(ccfg);
@@ -185,8 +250,9 @@ bool UnitBME688::begin()
     }
 
 #if defined(UNIT_BME688_USING_BSEC2)
-    auto ret  = bsec_init();
-    auto vret = bsec_get_version(&_bsec2_version);
+    _shadow_forced = false;
+    auto ret       = bsec_init();
+    auto vret      = bsec_get_version(&_bsec2_version);
     if (ret != BSEC_OK || vret != BSEC_OK) {
         M5_LIB_LOGE("Failed to bsec_init or gert_version %d/%d", ret, vret);
         return false;
@@ -198,6 +264,10 @@ bool UnitBME688::begin()
         M5_LIB_LOGE("Failed to set default config");
         return false;
     }
+    // The state must be restored after the configuration and before the subscription
+    if (_cfg.state && !bsec2SetState(_cfg.state)) {
+        M5_LIB_LOGW("Failed to restore the state");
+    }
 #else
     bme688::bme68xConf tph{};
     tph.os_temp = m5::stl::to_underlying(_cfg.oversampling_temperature);
@@ -281,8 +351,9 @@ void UnitBME688::update(const bool force)
 // Using BSEC2 library and configuration and state
 void UnitBME688::update_bsec2(const bool force)
 {
-    auto now       = m5::utility::millis();
-    int64_t now_ns = now * 1000000ULL;  // ms to ns
+    auto now = m5::utility::millis();
+    // Monotonic 64bit microseconds, millis() resolution is not enough for BSEC2
+    const int64_t now_ns = esp_timer_get_time() * 1000LL;  // us to ns
 
     _bsec2_mode = static_cast<Mode>(_bsec2_settings.op_mode);
 
@@ -290,9 +361,26 @@ void UnitBME688::update_bsec2(const bool force)
         return;
     }
 
+    // Keep the cadence on the schedule of BSEC2 if the lateness is within the tolerance
+    int64_t ts_ns = now_ns;
+    if (!force && _bsec2_settings.next_call > 0) {
+        const uint64_t late = (now_ns - _bsec2_settings.next_call) / 1000;  // ns to us
+        const uint32_t late32 =
+            late > std::numeric_limits<uint32_t>::max() ? std::numeric_limits<uint32_t>::max() : (uint32_t)late;
+        ++_jitter.count;
+        _jitter.last = late32;
+        _jitter.max  = std::max(_jitter.max, late32);
+        _jitter.total += late32;
+        if (late32 <= _cfg.lateness_tolerance) {
+            ts_ns = _bsec2_settings.next_call;
+        } else {
+            ++_jitter.violations;
+        }
+    }
+
     // M5_LIB_LOGW("_bsec2_mode:%u", _bsec2_mode);
 
-    auto ret = bsec_sensor_control(now_ns, &_bsec2_settings);
+    auto ret = bsec_sensor_control(ts_ns, &_bsec2_settings);
     if (ret != BSEC_OK) {
         M5_LIB_LOGW("Failed to bsec_sensor_control %d", ret);
         return;
@@ -330,15 +418,17 @@ void UnitBME688::update_bsec2(const bool force)
             do {
                 auto& d = _raw_data[idx];
                 if (d.status & BME68X_GASM_VALID_MSK) {
-                    d.pressure *= 0.01f;  // Conversion from Pa to hPa
                     Data data{};
-                    if (!process_data(data.raw_outputs, now_ns, d)) {
+                    if (!process_data(_outputs, ts_ns, d)) {
                         M5_LIB_LOGE("Failed to process_data");
                         break;
                     }
                     ++valid;
                     data.raw = d;
+                    data.store(_outputs);
+                    preprocess(data, now);
                     _data->push_back(data);
+                    postprocess(data);
                 }
             } while (++idx < _num_of_data);
             if (valid) {
@@ -400,8 +490,27 @@ void UnitBME688::update_bme688(const bool force)
             _latest = at;
             for (uint_fast8_t i = 0; i < _num_of_data; ++i) {
                 Data d{};
-                d.raw = _raw_data[i];
+                d.raw     = _raw_data[i];
+                d.profile = _profile_index;
+                preprocess(d, at);
                 _data->push_back(d);
+                postprocess(d);
+                // A full scan is completed with the last step, the same field read again is not counted
+                if (!_profiles.empty() && d.raw.gas_index + 1 >= _profiles[_profile_index].heater.profile_len &&
+                    d.raw.meas_index != _scan_meas_index) {
+                    ++_profile_scans;
+                    _scan_meas_index = d.raw.meas_index;
+                }
+            }
+            // Move to the next profile
+            if (_profiles.size() > 1 && _profile_scans >= _profiles[_profile_index].scans) {
+                _profile_index = (_profile_index + 1) % _profiles.size();
+                if (!writeMode(Mode::Sleep) || !apply_profile(_profiles[_profile_index])) {
+                    M5_LIB_LOGE("Failed to apply profile %s", _profiles[_profile_index].name);
+                    _profiles.clear();
+                    _profile_index = 0;
+                    _periodic      = false;
+                }
             }
         }
     }
@@ -423,6 +532,9 @@ bool UnitBME688::readUniqueID(uint32_t& id)
 
 bool UnitBME688::softReset()
 {
+#if defined(UNIT_BME688_USING_BSEC2)
+    _shadow_forced = false;
+#endif
     return (bme68x_soft_reset(&_dev) == BME68X_OK) &&
            // reload settings
            bme68x_get_conf(&_tphConf, &_dev) == BME68X_OK && bme68x_get_heatr_conf(&_heaterConf, &_dev) == BME68X_OK;
@@ -667,7 +779,8 @@ bool UnitBME688::readHeaterSetting(bme688::bme68xHeatrConf& hs)
 bool UnitBME688::writeHeaterSetting(const Mode mode, const bme688::bme68xHeatrConf& hs)
 {
     if (bme68x_set_heatr_conf(m5::stl::to_underlying(mode), &hs, &_dev) == BME68X_OK) {
-        _heaterConf = hs;
+        _heaterConf  = hs;
+        _heater_mode = mode;
         return true;
     }
     return false;
@@ -723,6 +836,60 @@ bool UnitBME688::measureSingleShot(bme688::bme68xData& data)
     return false;
 }
 
+bool UnitBME688::startSingleShot(types::elapsed_time_t& deadline)
+{
+    deadline = 0;
+    if (inPeriodic()) {
+        M5_LIB_LOGE("Periodic measurements are running");
+        return false;
+    }
+
+    if (writeMode(Mode::Sleep) && writeMode(Mode::Forced)) {
+        auto interval_us      = calculateMeasurementInterval(_mode, _tphConf) + (_heaterConf.heatr_dur * 1000);
+        _single_shot_deadline = m5::utility::millis() + interval_us / 1000 + ((interval_us % 1000) != 0);
+        _single_shot          = true;
+        deadline              = _single_shot_deadline;
+        return true;
+    }
+    return false;
+}
+
+bool UnitBME688::pollSingleShot(bme688::bme68xData& data)
+{
+    constexpr types::elapsed_time_t TIMEOUT{100};
+
+    // Periodic measurement started after the trigger overrides it
+    if (!_single_shot || inPeriodic()) {
+        _single_shot = false;
+        return false;
+    }
+    auto now = m5::utility::millis();
+    if (now < _single_shot_deadline) {
+        return false;
+    }
+
+    uint8_t status{};
+    if (!readRegister8(MEASUREMENT_STATUS_0, status, 0)) {
+        M5_LIB_LOGE("Failed to read status");
+        _single_shot = false;
+        return false;
+    }
+    if (!(status & BME68X_NEW_DATA_MSK)) {
+        if (now >= _single_shot_deadline + TIMEOUT) {
+            M5_LIB_LOGE("Timeout");
+            _single_shot = false;
+        }
+        return false;
+    }
+
+    _single_shot = false;
+    if (read_fields()) {
+        data = _raw_data[0];
+        return true;
+    }
+    return false;
+}
+
 bool UnitBME688::start_periodic_measurement(const Mode m)
 {
     if (inPeriodic()) {
@@ -762,8 +929,72 @@ bool UnitBME688::start_periodic_measurement(const Mode m)
     return _periodic;
 }
 
+bool UnitBME688::start_periodic_measurement(const bme688::HeaterProfile* profiles, const size_t num)
+{
+    if (inPeriodic()) {
+        M5_LIB_LOGD("Periodic measurements are running");
+        return false;
+    }
+    if (!profiles || !num || num > std::numeric_limits<uint8_t>::max()) {
+        M5_LIB_LOGE("Invalid profiles");
+        return false;
+    }
+    for (size_t i = 0; i < num; ++i) {
+        const auto& p = profiles[i];
+        if ((p.mode != Mode::Parallel && p.mode != Mode::Sequential) || !p.heater.enable ||
+            !p.heater.profile_len || p.heater.profile_len > 10 || !p.scans) {
+            M5_LIB_LOGE("Invalid profile %u:%s", (unsigned)i, p.name ? p.name : "");
+            return false;
+        }
+    }
+
+    _profiles.assign(profiles, profiles + num);
+    _profile_index = 0;
+    _latest        = 0;
+    if (!apply_profile(_profiles.front())) {
+        _profiles.clear();
+        return false;
+    }
+    _periodic = true;
+    return true;
+}
+
+bool UnitBME688::apply_profile(const bme688::HeaterProfile& p)
+{
+    if (!writeHeaterSetting(p.mode, p.heater) || !writeMode(p.mode)) {
+        return false;
+    }
+
+    // Duration of each step from the actual TPH and heater settings
+    const uint32_t tph_us = calculateMeasurementInterval(p.mode, _tphConf);
+    uint32_t min_us{std::numeric_limits<uint32_t>::max()}, total_us{};
+    for (uint_fast8_t i = 0; i < p.heater.profile_len; ++i) {
+        uint32_t step_us =
+            (p.mode == Mode::Parallel)
+                ? std::max<uint32_t>(p.heater.dur_prof[i], 1) * (tph_us + p.heater.shared_heatr_dur * 1000U)
+                : tph_us + p.heater.dur_prof[i] * 1000U;
+        min_us = std::min(min_us, step_us);
+        total_us += step_us;
+    }
+    // Poll every shortest step so that the 3 fields on the chip are not overwritten
+    _interval         = min_us / 1000 + ((min_us % 1000) != 0);
+    _profile_duration = total_us / 1000 + ((total_us % 1000) != 0);
+    _profile_scans    = 0;
+    _scan_meas_index  = -1;
+    M5_LIB_LOGD("Profile:%s interval:%u duration:%u", p.name ? p.name : "", (unsigned)_interval,
+                (unsigned)_profile_duration);
+
+    // Always wait for an interval to obtain the correct value for the first measurement
+    _can_measure_time = m5::utility::millis() + _interval;
+    _waiting          = true;
+    return true;
+}
+
 bool UnitBME688::stop_periodic_measurement()
 {
+    _profiles.clear();
+    _profile_index    = 0;
+    _profile_duration = 0;
 #if defined(UNIT_BME688_USING_BSEC2)
     if (_bsec2_subscription) {
         if (!bsec2UnsubscribeAll()) {
@@ -780,7 +1011,50 @@ bool UnitBME688::stop_periodic_measurement()
 
 bool UnitBME688::read_measurement()
 {
-    return bme68x_get_data(m5::stl::to_underlying(_mode), _raw_data, &_num_of_data, &_dev) == BME68X_OK;
+    return read_fields();
+}
+
+bool UnitBME688::read_fields()
+{
+#if defined(BME68X_USE_FPU)
+    // All the field blocks and heater settings in one transaction instead of bme68x_get_data
+    static_assert(MEASUREMENT_STATUS_0 == burst::START && GAS_WAIT_0 + 9 == burst::START + burst::LENGTH - 1,
+                  "Illegal window");
+    _num_of_data = 0;
+    if (_mode == Mode::Forced) {
+        // Wait for the new data as read_field_data in bme68x.c does, the field may not be updated yet
+        uint8_t status{};
+        uint32_t tries{NEW_DATA_TRIES};
+        while (true) {
+            if (!readRegister8(MEASUREMENT_STATUS_0, status, 0)) {
+                return false;
+            }
+            if ((status & BME68X_NEW_DATA_MSK) || !--tries) {
+                break;
+            }
+            m5::utility::delay(NEW_DATA_POLL_MS);
+        }
+        if (!(status & BME68X_NEW_DATA_MSK)) {
+            return false;
+        }
+    }
+    uint8_t window[burst::LENGTH]{};
+    if (!readRegister(burst::START, window, sizeof(window), 0)) {
+        return false;
+    }
+    _num_of_data = burst::decode(_raw_data, window, m5::stl::to_underlying(_mode), _dev.calib, _dev.variant_id);
+    return _num_of_data != 0;
+#else
+    // The local decoder writes the floating point fields, so use the Sensor API for the integer fields
+    _num_of_data = 0;
+    if (bme68x_get_data(m5::stl::to_underlying(_mode), _raw_data, &_num_of_data, &_dev) != BME68X_OK) {
+        return false;
+    }
+    if (_mode == Mode::Forced) {
+        _num_of_data = (_num_of_data >= 1) ? 1 : 0;  // 1 data if forced
+    }
+    return _num_of_data != 0;
+#endif
 }
 
 #if defined(UNIT_BME688_USING_BSEC2)
@@ -793,19 +1067,45 @@ bool UnitBME688::start_periodic_measurement(const uint32_t subscribe_bits, const
     _latest   = 0;
     _waiting  = false;
     _interval = interval_table[m5::stl::to_underlying(sr)];
+    // The schedule restarts, so the lateness is not counted on the first call
+    _bsec2_settings.next_call = 0;
     return bsec2UnsubscribeAll() && bsec2UpdateSubscription(subscribe_bits, sr);
 }
 
+bool UnitBME688::bsec2SetWorkBuffer(uint8_t* buf, const size_t size)
+{
+    if (buf && size < BSEC_MAX_WORKBUFFER_SIZE) {
+        M5_LIB_LOGE("Not enough size %u < %u", (unsigned)size, (unsigned)BSEC_MAX_WORKBUFFER_SIZE);
+        return false;
+    }
+    auto& w = bsec2_work();
+    std::lock_guard<std::mutex> lock(w.mutex);
+    w.owned.reset();
+    w.buffer = buf;
+    return true;
+}
+
 bool UnitBME688::bsec2GetConfig(uint8_t* cfg, uint32_t& actualSize)
 {
-    return cfg && bsec_get_configuration(0, cfg, BSEC_MAX_PROPERTY_BLOB_SIZE, _bsec2_work.get(),
-                                         BSEC_MAX_WORKBUFFER_SIZE, &actualSize) == BSEC_OK;
+    std::lock_guard<std::mutex> lock(bsec2_work().mutex);
+    auto work = acquire_bsec2_work();
+    return cfg && work &&
+           bsec_get_configuration(0, cfg, BSEC_MAX_PROPERTY_BLOB_SIZE, work, BSEC_MAX_WORKBUFFER_SIZE, &actualSize) ==
+               BSEC_OK;
 }
 
 bool UnitBME688::bsec2SetConfig(const uint8_t* cfg, const size_t sz)
 {
     if (cfg) {
-        auto ret = bsec_set_configuration(cfg, sz, _bsec2_work.get(), BSEC_MAX_WORKBUFFER_SIZE);
+        bsec_library_return_t ret{};
+        {
+            std::lock_guard<std::mutex> lock(bsec2_work().mutex);
+            auto work = acquire_bsec2_work();
+            if (!work) {
+                return false;
+            }
+            ret = bsec_set_configuration(cfg, sz, work, BSEC_MAX_WORKBUFFER_SIZE);
+        }
         return (ret == BSEC_OK) ? readCalibration(_dev.calib) && readTPHSetting(_tphConf) : false;
     }
     return false;
@@ -813,14 +1113,17 @@ bool UnitBME688::bsec2SetConfig(const uint8_t* cfg, const size_t sz)
 
 bool UnitBME688::bsec2GetState(uint8_t* state, uint32_t& actualSize)
 {
-    return state && bsec_get_state(0, state, BSEC_MAX_STATE_BLOB_SIZE, _bsec2_work.get(), BSEC_MAX_WORKBUFFER_SIZE,
-                                   &actualSize) == BSEC_OK;
+    std::lock_guard<std::mutex> lock(bsec2_work().mutex);
+    auto work = acquire_bsec2_work();
+    return state && work &&
+           bsec_get_state(0, state, BSEC_MAX_STATE_BLOB_SIZE, work, BSEC_MAX_WORKBUFFER_SIZE, &actualSize) == BSEC_OK;
 }
 
 bool UnitBME688::bsec2SetState(const uint8_t* state)
 {
-    return state &&
-           bsec_set_state(state, BSEC_MAX_STATE_BLOB_SIZE, _bsec2_work.get(), BSEC_MAX_WORKBUFFER_SIZE) == BSEC_OK;
+    std::lock_guard<std::mutex> lock(bsec2_work().mutex);
+    auto work = acquire_bsec2_work();
+    return state && work && bsec_set_state(state, BSEC_MAX_STATE_BLOB_SIZE, work, BSEC_MAX_WORKBUFFER_SIZE) == BSEC_OK;
 }
 
 bool UnitBME688::bsec2UpdateSubscription(const uint32_t sensorBits, const bme688::bsec2::SampleRate sr)
@@ -830,6 +1133,13 @@ bool UnitBME688::bsec2UpdateSubscription(const uint32_t sensorBits, const bme688
         return false;
     }
 
+    // Each bme688::Data holds only MAX_OUTPUTS outputs
+    if (__builtin_popcount(sensorBits & ~1U) > bme688::bsec2::MAX_OUTPUTS) {
+        M5_LIB_LOGE("Too many outputs %u > %u (UNIT_BME688_BSEC2_MAX_OUTPUTS)",
+                    (unsigned)__builtin_popcount(sensorBits & ~1U), (unsigned)bme688::bsec2::MAX_OUTPUTS);
+        return false;
+    }
+
     bsec_sensor_configuration_t vs[BSEC_NUMBER_OUTPUTS]{}, ss[BSEC_MAX_PHYSICAL_SENSOR]{};
     uint8_t ssLen{BSEC_MAX_PHYSICAL_SENSOR};
     // idx 1:BSEC_OUTPUT_IAQ - 30:BSEC_OUTPUT_REGRESSION_ESTIMATE_4
@@ -858,6 +1168,11 @@ bool UnitBME688::bsec2UpdateSubscription(const uint32_t sensorBits, const bme688
 
 bool UnitBME688::bsec2Subscribe(const bsec_virtual_sensor_t id)
 {
+    if (__builtin_popcount((_bsec2_subscription | (1U << id)) & ~1U) > bme688::bsec2::MAX_OUTPUTS) {
+        M5_LIB_LOGE("Too many outputs (UNIT_BME688_BSEC2_MAX_OUTPUTS:%u)", (unsigned)bme688::bsec2::MAX_OUTPUTS);
+        return false;
+    }
+
     bsec_sensor_configuration_t vs[1]{}, ss[BSEC_MAX_PHYSICAL_SENSOR]{};
     uint8_t ssLen{BSEC_MAX_PHYSICAL_SENSOR};
 
@@ -909,10 +1224,38 @@ bool UnitBME688::write_mode_forced()
     hs.enable     = true;
     hs.heatr_temp = _bsec2_settings.heater_temperature;
     hs.heatr_dur  = _bsec2_settings.heater_duration;
-    return writeOversampling((Oversampling)_bsec2_settings.temperature_oversampling,
-                             (Oversampling)_bsec2_settings.pressure_oversampling,
-                             (Oversampling)_bsec2_settings.humidity_oversampling) &&
-           writeHeaterSetting(Mode::Forced, hs) && writeMode(Mode::Forced);
+
+    // Nothing changed since the last cycle, only the mode trigger is needed
+    if (_shadow_forced && _heater_mode == Mode::Forced && _heaterConf.enable &&
+        _heaterConf.heatr_temp == hs.heatr_temp && _heaterConf.heatr_dur == hs.heatr_dur &&
+        _tphConf.os_temp == _bsec2_settings.temperature_oversampling &&
+        _tphConf.os_pres == _bsec2_settings.pressure_oversampling &&
+        _tphConf.os_hum == _bsec2_settings.humidity_oversampling) {
+        // The sensor returns to sleep mode after the previous forced measurement,
+        // so the mode can be written without the read-modify-write of bme68x_set_op_mode
+        uint8_t v = (_tphConf.os_temp << 5) | (_tphConf.os_pres << 2) | m5::stl::to_underlying(Mode::Forced);
+        if (writeRegister8(CTRL_MEASUREMENT, v)) {
+            _mode = Mode::Forced;
+            ++_shadow_counter.trigger_only;
+            _shadow_counter.saved += _shadow_cost - 1;
+            return true;
+        }
+        _shadow_forced = false;
+        return false;
+    }
+
+    auto before = _transactions;
+    _shadow_forced =
+        writeOversampling((Oversampling)_bsec2_settings.temperature_oversampling,
+                          (Oversampling)_bsec2_settings.pressure_oversampling,
+                          (Oversampling)_bsec2_settings.humidity_oversampling) &&
+        writeHeaterSetting(Mode::Forced, hs) && writeMode(Mode::Forced);
+    if (_shadow_forced) {
+        // writeOversampling accesses registers directly (2 reads and 2 writes)
+        _shadow_cost = _transactions - before + 4;
+        ++_shadow_counter.full;
+    }
+    return _shadow_forced;
 }
 
 bool UnitBME688::write_mode_parallel()
@@ -938,14 +1281,8 @@ bool UnitBME688::write_mode_parallel()
 
 bool UnitBME688::fetch_data()
 {
-    _num_of_data = 0;
-    if (bme68x_get_data(m5::stl::to_underlying(_mode), _raw_data, &_num_of_data, &_dev) == BME68X_OK) {
-        if (_mode == Mode::Forced) {
-            _num_of_data = (_num_of_data >= 1) ? 1 : 0;  // 1 data if forced
-        }
-        return true;
-    }
-    return false;
+    // Forced mode decodes only the field 0, so at most 1 data
+    return read_fields();
 }
 
 // From bsec2.h (BSD-3-Clause)
@@ -987,7 +1324,7 @@ bool UnitBME688::process_data(bsecOutputs& outputs, const int64_t ns, const bme6
     }
     if (BSEC_CHECK_INPUT(_bsec2_settings.process_data, BSEC_INPUT_PRESSURE)) {
         inputs[nInputs].sensor_id  = BSEC_INPUT_PRESSURE;
-        inputs[nInputs].signal     = data.pressure;
+        inputs[nInputs].signal     = data.pressure * 0.01f;  // Conversion from Pa to hPa
         inputs[nInputs].time_stamp = ns;
         nInputs++;
     }
@@ -12,6 +12,7 @@
 
 #include <M5UnitComponent.hpp>
 #include <m5_utility/stl/extension.hpp>
+#include "processing_adapter.hpp"
 
 #if defined(ARDUINO)
 #include <bme68xLibrary.h>
@@ -28,10 +29,33 @@
 #include <inc/bsec_datatypes.h>
 #endif
 
+#if !defined(UNIT_BME688_BSEC2_MAX_OUTPUTS)
+/*!
+  @def UNIT_BME688_BSEC2_MAX_OUTPUTS
+  @brief Maximum number of subscribed BSEC2 outputs that each bme688::Data can hold
+  @details Define it (1 - 32) before including if you subscribe more outputs
+ */
+#define UNIT_BME688_BSEC2_MAX_OUTPUTS (8)
+#endif
+
+#if defined(DOXYGEN_PROCESS)
+/*!
+  @def UNIT_BME688_BSEC2_RAW_OUTPUTS_MEMBER
+  @brief Keep bme688::Data::raw_outputs as the data member (bsecOutputs) as in the former versions
+  @details Define it before including if the code accesses raw_outputs.output[i] or raw_outputs.nOutputs.
+  Otherwise raw_outputs() is a deprecated function, and each Data is smaller by sizeof(bsecOutputs)
+ */
+#define UNIT_BME688_BSEC2_RAW_OUTPUTS_MEMBER
+#endif
+
 #endif
 
 #include <memory>
 #include <limits>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 #include <initializer_list>
 
 namespace m5 {
@@ -81,6 +105,22 @@ struct bme68xHeatrConf : bme68x_heatr_conf {
         heatr_temp_prof = temp_prof;
         heatr_dur_prof  = dur_prof;
     }
+    bme68xHeatrConf(const bme68xHeatrConf& o) : bme68xHeatrConf()
+    {
+        *this = o;
+    }
+    //! @note Pointers are kept pointing to its own profiles
+    bme68xHeatrConf& operator=(const bme68xHeatrConf& o)
+    {
+        if (this != &o) {
+            static_cast<bme68x_heatr_conf&>(*this) = o;
+            std::copy(std::begin(o.temp_prof), std::end(o.temp_prof), std::begin(temp_prof));
+            std::copy(std::begin(o.dur_prof), std::end(o.dur_prof), std::begin(dur_prof));
+            heatr_temp_prof = temp_prof;
+            heatr_dur_prof  = dur_prof;
+        }
+        return *this;
+    }
 };
 /*!
   @typedef bme68xCalibration
@@ -89,6 +129,26 @@ struct bme68xHeatrConf : bme68x_heatr_conf {
 using bme68xCalibration = struct bme68x_calib_data;
 ///@}
 
+/*!
+  @struct HeaterProfile
+  @brief Named heater profile for the sequencer
+  @sa UnitBME688::startPeriodicMeasurement(const bme688::HeaterProfile*, const size_t)
+ */
+struct HeaterProfile {
+    //! Name of the profile
+    const char* name{};
+    //! Parallel or Sequential
+    Mode mode{Mode::Parallel};
+    /*!
+      Heater steps (profile_len 1 - 10)
+      @note Parallel: dur_prof are multiples of the TPHG cycle (TPH + shared_heatr_dur)
+      @note Sequential: dur_prof are milliseconds
+     */
+    bme68xHeatrConf heater{};
+    //! Number of full scans before moving to the next profile
+    uint32_t scans{1};
+};
+
 /*!
   @enum Oversampling
   @brief Sampling setting
@@ -246,23 +306,109 @@ uint32_t subscribe_to_bits(Args... args)
     return virtual_sensor_array_to_bits(tmp, n);
 }
 
+/*!
+  @struct ShadowCounter
+  @brief Statistics of the shadow register cache for forced mode
+ */
+struct ShadowCounter {
+    uint32_t full{};          //!< @brief Cycles that wrote oversampling, heater and mode
+    uint32_t trigger_only{};  //!< @brief Cycles that wrote only the mode trigger
+    uint32_t saved{};         //!< @brief I2C transactions saved by trigger only cycles
+};
+
+/*!
+  @struct Jitter
+  @brief Statistics of the lateness of scheduled BSEC2 calls against next_call
+ */
+struct Jitter {
+    uint32_t count{};       //!< @brief Number of scheduled calls
+    uint32_t violations{};  //!< @brief Calls later than the tolerance (not compensated)
+    uint32_t last{};        //!< @brief Last lateness (us)
+    uint32_t max{};         //!< @brief Maximum lateness (us)
+    uint64_t total{};       //!< @brief Sum of lateness (us)
+    //! @brief Mean lateness (us)
+    inline uint32_t mean() const
+    {
+        return count ? static_cast<uint32_t>(total / count) : 0;
+    }
+};
+
+//! @brief Maximum number of subscribed outputs held in bme688::Data
+constexpr uint8_t MAX_OUTPUTS{UNIT_BME688_BSEC2_MAX_OUTPUTS};
+static_assert(MAX_OUTPUTS > 0 && MAX_OUTPUTS <= 32, "UNIT_BME688_BSEC2_MAX_OUTPUTS must be 1 - 32");
+
 }  // namespace bsec2
 #endif
 
+/*!
+  @enum Field
+  @brief Scalar fields of the measurement data
+ */
+enum class Field : uint8_t {
+    Temperature,  //!< Raw temperature (Celsius)
+    Pressure,     //!< Raw pressure (Pa)
+    Humidity,     //!< Raw humidity (RH)
+    Gas,          //!< Raw gas resistance (Ohm)
+};
+
+//! @brief Statistics of the fields
+using Statistics = statistics::Statistics<Field, 4>;
+//! @brief Change detection of the fields
+using Deadband = deadband::Deadband<Field, 4>;
+//! @brief Software filters of the fields
+using FilterPipeline = filter::Pipeline<Field, 4>;
+
 /*!
   @struct Data
   @brief Measurement data group
  */
-struct Data {
+struct Data : processing::Sample<Field, 4> {
+    //! @brief Raw data of the sample (pressure is always Pa, also if BSEC2 is used)
     bme688::bme68xData raw{};
 #if defined(UNIT_BME688_USING_BSEC2)
-    bsecOutputs raw_outputs{};
+    //! @brief Bit per virtual sensor stored in signal (1U << bsec_virtual_sensor_t)
+    uint32_t mask{};
+    //! @brief Accuracy of each stored output, 2 bits each in the order of signal
+    uint64_t accuracies{};
+    //! @brief Signal of the subscribed outputs in ascending order of virtual sensor
+    std::array<float, bsec2::MAX_OUTPUTS> signal{};
 
-    float get(const bsec_virtual_sensor_t vs) const;
+    /*!
+      @brief Store the outputs
+      @details Outputs that exceed bsec2::MAX_OUTPUTS are discarded
+     */
+    void store(const bsecOutputs& outputs);
+#if defined(UNIT_BME688_BSEC2_RAW_OUTPUTS_MEMBER)
+    //! @brief Outputs as received from BSEC2 (only if UNIT_BME688_BSEC2_RAW_OUTPUTS_MEMBER is defined)
+    bsecOutputs raw_outputs{};
+#else
+    /*!
+      @brief Rebuild the stored outputs as bsecOutputs
+      @details Source breaking change: the former data member raw_outputs is a function now.
+      Define UNIT_BME688_BSEC2_RAW_OUTPUTS_MEMBER to keep the member
+      @note time_stamp is not stored (0) and signal_dimensions is 1
+      @deprecated Use get() and accuracy() instead
+     */
+    [[deprecated("Use get() and accuracy()")]] bsecOutputs raw_outputs() const;
+#endif
+    //! @brief Value of the virtual sensor, NaN if not exists
+    inline float get(const bsec_virtual_sensor_t vs) const
+    {
+        return exists(vs) ? signal[position(vs)] : std::numeric_limits<float>::quiet_NaN();
+    }
+    //! @brief Accuracy of the virtual sensor (0:Unreliable - 3:High), 0 if not exists
+    inline uint8_t accuracy(const bsec_virtual_sensor_t vs) const
+    {
+        return exists(vs) ? (accuracies >> (position(vs) * 2)) & 0x03 : 0;
+    }
     inline float iaq() const
     {
         return get(BSEC_OUTPUT_IAQ);
     }
+    inline uint8_t iaq_accuracy() const
+    {
+        return accuracy(BSEC_OUTPUT_IAQ);
+    }
     inline float static_iaq() const
     {
         return get(BSEC_OUTPUT_STATIC_IAQ);
@@ -347,7 +493,24 @@ struct Data {
     {
         return get(BSEC_OUTPUT_REGRESSION_ESTIMATE_4);
     }
+    //! @brief Is the virtual sensor stored?
+    inline bool exists(const bsec_virtual_sensor_t vs) const
+    {
+        return vs < 32 && (mask & (1U << vs));
+    }
+    //! @brief Position of the virtual sensor in signal (valid if exists)
+    inline uint32_t position(const bsec_virtual_sensor_t vs) const
+    {
+        return __builtin_popcount(mask & ((1U << vs) - 1U));
+    }
 #endif
+    //! @brief Index of the heater profile of the sequencer (0 if not sequenced)
+    uint8_t profile{};
+    //! @brief Heater profile step (gas_index) of the sample
+    inline uint8_t step() const
+    {
+        return raw.gas_index;
+    }
     inline float raw_temperature() const
     {
         return raw.temperature;
@@ -364,6 +527,11 @@ struct Data {
     {
         return raw.gas_resistance;
     }
+    //! @brief Values of the fields in the order of Field (pressure is Pa also if BSEC2 is used)
+    inline Statistics::values_t values() const
+    {
+        return {{raw_temperature(), raw_pressure(), raw_humidity(), raw_gas()}};
+    }
 };
 
 }  // namespace bme688
@@ -374,7 +542,9 @@ struct Data {
   @note Using config/bme688/bme688_sel_33v_3s_4d/bsec_selectivity.txt for default configuration
   @note If other settings are used, call bsec2SetConfig
  */
-class UnitBME688 : public Component, public PeriodicMeasurementAdapter<UnitBME688, bme688::Data> {
+class UnitBME688 : public Component,
+                   public PeriodicMeasurementAdapter<UnitBME688, bme688::Data>,
+                   public ProcessingAdapter<UnitBME688, bme688::Data, bme688::Field, 4> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitBME688, 0x77);
 
 public:
@@ -401,6 +571,19 @@ public:
           required in advance.
         */
         bme688::bsec2::SampleRate sample_rate{bme688::bsec2::SampleRate::LowPower};
+        /*!
+          @brief BSEC2 state restored on begin if not nullptr
+          @note Must be BSEC_MAX_STATE_BLOB_SIZE bytes and valid until begin
+          @sa bme688::StateManager
+        */
+        const uint8_t* state{};
+        /*!
+          @brief Lateness (us) against next_call compensated for BSEC2
+          @details If update is called within this lateness, BSEC2 is given next_call as the timestamp
+          so that the cadence does not drift. Later calls are given the actual time
+          @note BSEC2 reports timing violations over 6.25% of the sample interval
+        */
+        uint32_t lateness_tolerance{100 * 1000U};
 #endif
 #if !defined(UNIT_BME688_USING_BSEC2) || defined(DOXYGEN_PROCESS)
         ///@name Only Nano6
@@ -476,6 +659,16 @@ public:
     {
         return _dev.amb_temp;
     }
+    //! @brief Gets the current profile of the sequencer, nullptr if not sequenced
+    inline const bme688::HeaterProfile* currentProfile() const
+    {
+        return _profiles.empty() ? nullptr : &_profiles[_profile_index];
+    }
+    //! @brief Gets the duration (ms) of a full scan of the current profile of the sequencer
+    inline uint32_t profileDuration() const
+    {
+        return _profile_duration;
+    }
     ///@}
 
     ///@name Measurement data by periodic
@@ -741,6 +934,19 @@ public:
     }
 
 #endif
+    /*!
+      @brief Start periodic measurement cycling the heater profiles without BSEC2
+      @details Each profile is scanned HeaterProfile::scans times, then the next one is written.
+      Pushed data are tagged with the profile index and the step (gas_index)
+      @param profiles Profiles (copied)
+      @param num Number of profiles
+      @return True if successful
+      @pre Calibration and TPH must already be set up
+    */
+    inline bool startPeriodicMeasurement(const bme688::HeaterProfile* profiles, const size_t num)
+    {
+        return PeriodicMeasurementAdapter<UnitBME688, bme688::Data>::startPeriodicMeasurement(profiles, num);
+    }
     /*!
       @brief Stop periodic measurement
       @return True if successful
@@ -762,6 +968,27 @@ public:
       @note Blocked until it can be measured.
     */
     bool measureSingleShot(bme688::bme68xData& data);
+    /*!
+      @brief Trigger a single measurement without blocking
+      @param[out] deadline Time (m5::utility::millis) when the measurement is completed
+      @return True if successful
+      @pre Calibration,TPH and heater must already be set up
+      @note Measure once by Force mode, call pollSingleShot at or after the deadline
+    */
+    bool startSingleShot(types::elapsed_time_t& deadline);
+    /*!
+      @brief Complete the single measurement triggered by startSingleShot
+      @param[out] data output value
+      @return True if the measurement is completed and data is obtained
+      @note Nothing is accessed until the deadline, then the new data status bit is checked
+      @note Gives up if the new data is not available 100 ms after the deadline
+    */
+    bool pollSingleShot(bme688::bme68xData& data);
+    //! @brief Is the single measurement triggered by startSingleShot in progress?
+    inline bool inSingleShot() const
+    {
+        return _single_shot;
+    }
     ///@}
 
 #if defined(UNIT_BME688_USING_BSEC2) || defined(DOXYGEN_PROCESS)
@@ -783,6 +1010,17 @@ public:
     {
         _temperatureOffset = offset;
     }
+    /*!
+      @brief Set the work buffer for BSEC2
+      @details The work buffer is shared by all instances and access to it is serialized.
+      If not set, it is allocated from the heap on first use
+      @param buf Buffer at least BSEC_MAX_WORKBUFFER_SIZE bytes, nullptr to use the heap
+      @param size Size of buf
+      @return True if successful
+      @note Pass a static array to avoid the heap
+      @warning buf must be valid while any instance is in use
+     */
+    static bool bsec2SetWorkBuffer(uint8_t* buf, const size_t size);
     /*!
       @brief Gets the BSEC2 library version
       @return reference of the version structure
@@ -882,6 +1120,25 @@ public:
       @return True if successful
      */
     bool bsec2UnsubscribeAll();
+    /*!
+      @brief Gets the statistics of the shadow register cache
+      @details Forced mode cycles write only the mode trigger if the settings requested by BSEC2
+      are the same as those already written
+     */
+    inline const bme688::bsec2::ShadowCounter& bsec2ShadowCounter() const
+    {
+        return _shadow_counter;
+    }
+    //! @brief Gets the lateness statistics of the scheduled BSEC2 calls
+    inline const bme688::bsec2::Jitter& bsec2Jitter() const
+    {
+        return _jitter;
+    }
+    //! @brief Reset the lateness statistics
+    inline void bsec2ResetJitter()
+    {
+        _jitter = {};
+    }
 ///@}
 #endif
 
@@ -890,7 +1147,9 @@ protected:
     static int8_t write_function(uint8_t reg_addr, const uint8_t* reg_data, uint32_t length, void* intf_ptr);
 
     bool start_periodic_measurement(const bme688::Mode m);
+    bool start_periodic_measurement(const bme688::HeaterProfile* profiles, const size_t num);
     bool stop_periodic_measurement();
+    bool apply_profile(const bme688::HeaterProfile& p);
 #if defined(UNIT_BME688_USING_BSEC2)
     bool start_periodic_measurement(const uint32_t subscribe_bits, const bme688::bsec2::SampleRate sr);
 #endif
@@ -901,6 +1160,7 @@ protected:
 
     void update_bme688(const bool force);
     bool read_measurement();
+    bool read_fields();
 #if defined(UNIT_BME688_USING_BSEC2)
     bool process_data(bsecOutputs& outouts, const int64_t ns, const bme688::bme68xData& data);
     void update_bsec2(const bool force);
@@ -923,12 +1183,18 @@ protected:
     bme688::bme68xConf _tphConf{};
     bme688::bme68xHeatrConf _heaterConf{};
 
+    // Heater profile sequencer
+    std::vector<bme688::HeaterProfile> _profiles{};
+    uint8_t _profile_index{};
+    uint32_t _profile_scans{};
+    uint32_t _profile_duration{};  // Full scan (ms)
+    int16_t _scan_meas_index{-1};  // meas_index of the last step counted as a scan (-1: None)
+
     // BSEC2
     uint32_t _bsec2_subscription{};  // Enabled virtual sensor bit
 
 #if defined(UNIT_BME688_USING_BSEC2)
     bsec_version_t _bsec2_version{};
-    std::unique_ptr<uint8_t> _bsec2_work{};
     bsec_bme_settings_t _bsec2_settings{};
 
     bme688::Mode _bsec2_mode{};
@@ -936,12 +1202,23 @@ protected:
 
     bsecOutputs _outputs{};
     float _temperatureOffset{};
+
+    // Shadow register cache for forced mode
+    bool _shadow_forced{};     // Are the registers for forced mode the same as _tphConf/_heaterConf?
+    uint32_t _shadow_cost{};   // Transactions of the last full write
+    bme688::bsec2::ShadowCounter _shadow_counter{};
+
+    bme688::bsec2::Jitter _jitter{};
 #endif
+    bme688::Mode _heater_mode{};  // Mode of the last heater setting
+    uint32_t _transactions{};     // Transactions through read/write_function
 
     std::unique_ptr<m5::container::CircularBuffer<bme688::Data>> _data{};
 
     bool _waiting{};
     types::elapsed_time_t _can_measure_time{};
+    bool _single_shot{};
+    types::elapsed_time_t _single_shot_deadline{};
 
     config_t _cfg{};
 };
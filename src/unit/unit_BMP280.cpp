@@ -293,7 +293,9 @@ void UnitBMP280::update(const bool force)
                 // auto dur = at - _latest;
                 // M5_LIB_LOGW(">DUR:%ld\n", dur);
                 _latest = at;
+                preprocess(d, at);
                 _data->push_back(d);
+                postprocess(d);
             }
         }
     }
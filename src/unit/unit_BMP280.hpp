@@ -12,6 +12,8 @@
 
 #include <M5UnitComponent.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "processing_adapter.hpp"
+#include "barometric_altitude.hpp"
 #include <limits>  // NaN
 
 namespace m5 {
@@ -123,11 +125,27 @@ union Trimming {
     } __attribute__((packed));
 };
 
+/*!
+  @enum Field
+  @brief Scalar fields of the measurement data
+ */
+enum class Field : uint8_t {
+    Temperature,  //!< Temperature (Celsius)
+    Pressure,     //!< Pressure (Pa)
+};
+
+//! @brief Statistics of the fields
+using Statistics = statistics::Statistics<Field, 2>;
+//! @brief Change detection of the fields
+using Deadband = deadband::Deadband<Field, 2>;
+//! @brief Software filters of the fields
+using FilterPipeline = filter::Pipeline<Field, 2>;
+
 /*!
   @struct Data
   @brief Measurement data group
  */
-struct Data {
+struct Data : processing::Sample<Field, 2> {
     std::array<uint8_t, 6> raw{};  //!< RAW data [0,1,2]:pressure [3,4,5]:temperature
     const Trimming* trimming{};    //!< For calculate
 
@@ -139,6 +157,20 @@ struct Data {
     float celsius() const;     //!< temperature (Celsius)
     float fahrenheit() const;  //!< temperature (Fahrenheit)
     float pressure() const;    //!< pressure (Pa)
+    /*!
+      @brief Altitude (m)
+      @param sea_level Sea level pressure (Pa)
+      @sa barometric::altitude
+     */
+    inline float altitude(const float sea_level = barometric::STANDARD_SEA_LEVEL_PRESSURE) const
+    {
+        return barometric::altitude(pressure(), sea_level);
+    }
+    //! @brief Values of the fields in the order of Field
+    inline Statistics::values_t values() const
+    {
+        return {{celsius(), pressure()}};
+    }
 };
 
 }  // namespace bmp280
@@ -147,7 +179,9 @@ struct Data {
   @class UnitBMP280
   @brief Pressure and temperature sensor unit
 */
-class UnitBMP280 : public Component, public PeriodicMeasurementAdapter<UnitBMP280, bmp280::Data> {
+class UnitBMP280 : public Component,
+                   public PeriodicMeasurementAdapter<UnitBMP280, bmp280::Data>,
+                   public ProcessingAdapter<UnitBMP280, bmp280::Data, bmp280::Field, 2> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitBMP280, 0x76);
 
 public:
@@ -218,6 +252,11 @@ public:
     {
         return !empty() ? oldest().pressure() : std::numeric_limits<float>::quiet_NaN();
     }
+    //! @brief Oldest measured altitude (m) from the sea level pressure (Pa)
+    inline float altitude(const float sea_level = barometric::STANDARD_SEA_LEVEL_PRESSURE) const
+    {
+        return !empty() ? oldest().altitude(sea_level) : std::numeric_limits<float>::quiet_NaN();
+    }
     ///@}
 
     ///@name Periodic measurement
@@ -279,7 +279,9 @@ void UnitQMP6988::update(const bool force)
                 // auto dur = at - _latest;
                 // M5_LIB_LOGW(">DUR:%ld", dur);
                 _latest = at;
+                preprocess(d, at);
                 _data->push_back(d);
+                postprocess(d);
             }
         }
     }
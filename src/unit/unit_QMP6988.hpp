@@ -12,6 +12,8 @@
 #include <M5UnitComponent.hpp>
 #include <m5_utility/stl/extension.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "processing_adapter.hpp"
+#include "barometric_altitude.hpp"
 #include <limits>  // NaN
 
 namespace m5 {
@@ -106,11 +108,27 @@ struct Calibration {
 };
 ///@endcond
 
+/*!
+  @enum Field
+  @brief Scalar fields of the measurement data
+ */
+enum class Field : uint8_t {
+    Temperature,  //!< Temperature (Celsius)
+    Pressure,     //!< Pressure (Pa)
+};
+
+//! @brief Statistics of the fields
+using Statistics = statistics::Statistics<Field, 2>;
+//! @brief Change detection of the fields
+using Deadband = deadband::Deadband<Field, 2>;
+//! @brief Software filters of the fields
+using FilterPipeline = filter::Pipeline<Field, 2>;
+
 /*!
   @struct Data
   @brief Measurement data group
  */
-struct Data {
+struct Data : processing::Sample<Field, 2> {
     std::array<uint8_t, 6> raw{};  //!< RAW data
     //! temperature (Celsius)
     inline float temperature() const
@@ -120,7 +138,21 @@ struct Data {
     float celsius() const;     //!< temperature (Celsius)
     float fahrenheit() const;  //!< temperature (Fahrenheit)
     float pressure() const;    //!< pressure (Pa)
+    /*!
+      @brief Altitude (m)
+      @param sea_level Sea level pressure (Pa)
+      @sa barometric::altitude
+     */
+    inline float altitude(const float sea_level = barometric::STANDARD_SEA_LEVEL_PRESSURE) const
+    {
+        return barometric::altitude(pressure(), sea_level);
+    }
     const Calibration* calib{};
+    //! @brief Values of the fields in the order of Field
+    inline Statistics::values_t values() const
+    {
+        return {{celsius(), pressure()}};
+    }
 };
 
 }  // namespace qmp6988
@@ -129,7 +161,9 @@ struct Data {
   @class UnitQMP6988
   @brief Barometric pressure sensor to measure atmospheric pressure and altitude estimation
 */
-class UnitQMP6988 : public Component, public PeriodicMeasurementAdapter<UnitQMP6988, qmp6988::Data> {
+class UnitQMP6988 : public Component,
+                    public PeriodicMeasurementAdapter<UnitQMP6988, qmp6988::Data>,
+                    public ProcessingAdapter<UnitQMP6988, qmp6988::Data, qmp6988::Field, 2> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitQMP6988, 0x70);
 
 public:
@@ -201,6 +235,11 @@ public:
     {
         return !empty() ? oldest().pressure() : std::numeric_limits<float>::quiet_NaN();
     }
+    //! @brief Oldest measured altitude (m) from the sea level pressure (Pa)
+    inline float altitude(const float sea_level = barometric::STANDARD_SEA_LEVEL_PRESSURE) const
+    {
+        return !empty() ? oldest().altitude(sea_level) : std::numeric_limits<float>::quiet_NaN();
+    }
     ///@}
 
     ///@name Periodic measurement
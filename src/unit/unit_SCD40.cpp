@@ -128,7 +128,9 @@ void UnitSCD40::update(const bool force)
             _updated = read_measurement(d);
             if (_updated) {
                 _latest = m5::utility::millis();  // Data acquisition takes time, so acquire again
+                preprocess(d, at);
                 _data->push_back(d);
+                postprocess(d);
             }
         }
     }
@@ -12,6 +12,7 @@
 
 #include <M5UnitComponent.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "processing_adapter.hpp"
 #include <limits>  // NaN
 
 namespace m5 {
@@ -31,11 +32,28 @@ enum class Mode : uint8_t {
     LowPower,  //!< Low power (Receive data every 30 seconds)
 };
 
+/*!
+  @enum Field
+  @brief Scalar fields of the measurement data
+ */
+enum class Field : uint8_t {
+    CO2,          //!< CO2 concentration (ppm)
+    Temperature,  //!< Temperature (Celsius)
+    Humidity,     //!< Humidity (RH)
+};
+
+//! @brief Statistics of the fields
+using Statistics = statistics::Statistics<Field, 3>;
+//! @brief Change detection of the fields
+using Deadband = deadband::Deadband<Field, 3>;
+//! @brief Software filters of the fields
+using FilterPipeline = filter::Pipeline<Field, 3>;
+
 /*!
   @struct Data
   @brief Measurement data group
  */
-struct Data {
+struct Data : processing::Sample<Field, 3> {
     std::array<uint8_t, 9> raw{};  //!< @brief RAW data
     uint16_t co2() const;          //!< @brief CO2 concentration (ppm)
     //! @brief temperature (Celsius)
@@ -46,6 +64,11 @@ struct Data {
     float celsius() const;     //!< @brief temperature (Celsius)
     float fahrenheit() const;  //!< @brief temperature (Fahrenheit)
     float humidity() const;    //!< @brief humidity (RH)
+    //! @brief Values of the fields in the order of Field
+    inline Statistics::values_t values() const
+    {
+        return {{(float)co2(), celsius(), humidity()}};
+    }
 };
 
 ///@cond
@@ -78,7 +101,9 @@ constexpr uint16_t REINIT_DURATION{20};
   @class m5::unit::UnitSCD40
   @brief SCD40 unit component
 */
-class UnitSCD40 : public Component, public PeriodicMeasurementAdapter<UnitSCD40, scd4x::Data> {
+class UnitSCD40 : public Component,
+                  public PeriodicMeasurementAdapter<UnitSCD40, scd4x::Data>,
+                  public ProcessingAdapter<UnitSCD40, scd4x::Data, scd4x::Field, 3> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitSCD40, 0x62);
 
 public:
@@ -101,7 +101,9 @@ void UnitSGP30::update(const bool force)
             _updated = read_measurement(d);
             if (_updated) {
                 _latest = at;
+                preprocess(d, at);
                 _data->push_back(d);
+                postprocess(d);
             }
         }
     }
@@ -12,6 +12,7 @@
 
 #include <M5UnitComponent.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "processing_adapter.hpp"
 #include <array>
 
 namespace m5 {
@@ -63,14 +64,35 @@ struct Feature {
     uint16_t value{};
 };
 
+/*!
+  @enum Field
+  @brief Scalar fields of the measurement data
+ */
+enum class Field : uint8_t {
+    CO2eq,  //!< CO2eq (ppm)
+    TVOC,   //!< TVOC (ppb)
+};
+
+//! @brief Statistics of the fields
+using Statistics = statistics::Statistics<Field, 2>;
+//! @brief Change detection of the fields
+using Deadband = deadband::Deadband<Field, 2>;
+//! @brief Software filters of the fields
+using FilterPipeline = filter::Pipeline<Field, 2>;
+
 /*!
   @struct Data
   @brief Measurement data group
  */
-struct Data {
+struct Data : processing::Sample<Field, 2> {
     std::array<uint8_t, 6> raw{};  //!< RAW data
     uint16_t co2eq() const;        //!< Co2Eq (ppm)
     uint16_t tvoc() const;         //!< TVOC (ppb)
+    //! @brief Values of the fields in the order of Field
+    inline Statistics::values_t values() const
+    {
+        return {{(float)co2eq(), (float)tvoc()}};
+    }
 };
 
 }  // namespace sgp30
@@ -79,7 +101,9 @@ struct Data {
   @class UnitSGP30
   @brief SGP30 unit
  */
-class UnitSGP30 : public Component, public PeriodicMeasurementAdapter<UnitSGP30, sgp30::Data> {
+class UnitSGP30 : public Component,
+                  public PeriodicMeasurementAdapter<UnitSGP30, sgp30::Data>,
+                  public ProcessingAdapter<UnitSGP30, sgp30::Data, sgp30::Field, 2> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitSGP30, 0x58);
 
 public:
@@ -12,6 +12,8 @@
 #include <m5_unit_component/adapter_i2c.hpp>
 #include <limits>  // NaN
 #include <array>
+#include <cmath>
+#include <cstring>
 
 using namespace m5::utility::mmh3;
 using namespace m5::unit::types;
@@ -56,6 +58,14 @@ constexpr uint16_t periodic_cmd[] = {
     START_PERIODIC_MPS_10_MEDIUM,
     START_PERIODIC_MPS_10_LOW,
 };
+// Phase adjustment of the periodic read
+inline elapsed_time_t phase_step(const elapsed_time_t interval)
+{
+    return interval >= 40 ? interval / 20 : 2;
+}
+// Consecutive failures retried at the phase step, then at the interval
+constexpr uint8_t MAX_FAST_RETRY{4};
+
 constexpr elapsed_time_t interval_table[] = {
     2000,  // 0.5
     1000,  // 1
@@ -84,6 +94,21 @@ float Data::humidity() const
 {
     return 100.f * m5::types::big_uint16_t(raw[3], raw[4]).get() / 65536.f;
 }
+
+uint16_t alert_limit_to_raw(const float celsius, const float rh)
+{
+    float t = std::fmax(-45.0f, std::fmin(130.0f, celsius));
+    float h = std::fmax(0.0f, std::fmin(100.0f, rh));
+    auto traw = static_cast<uint16_t>(std::lround((t + 45.0f) * 65535.0f / 175.0f));
+    auto hraw = static_cast<uint16_t>(std::lround(h * 65535.0f / 100.0f));
+    return (hraw & 0xFE00) | (traw >> 7);
+}
+
+void raw_to_alert_limit(const uint16_t raw, float& celsius, float& rh)
+{
+    celsius = Temperature::toFloat((raw & 0x01FF) << 7);
+    rh      = 100.0f * (raw & 0xFE00) / 65535.0f;
+}
 }  // namespace sht30
 
 const char UnitSHT30::name[] = "UnitSHT30";
@@ -134,14 +159,71 @@ void UnitSHT30::update(const bool force)
     _updated = false;
     if (inPeriodic()) {
         elapsed_time_t at{m5::utility::millis()};
-        if (force || !_latest || at >= _latest + _interval) {
-            if (writeRegister(READ_MEASUREMENT)) {
-                Data d{};
-                _updated = read_measurement(d);
-                if (_updated) {
-                    _latest = at;
-                    _data->push_back(d);
+        if (force || at >= _next_read) {
+            // Watching the alert, only the status is read until an alert is pending
+            bool alerted{};
+            if (_watch_alert && !force) {
+                if (_watched_at && at < _watched_at + _interval) {
+                    return;
                 }
+                _watched_at = at;
+                Status s{};
+                if (!readStatus(s) || !s.alertPending()) {
+                    _next_read = at + _interval;
+                    return;
+                }
+                alerted = true;
+            }
+            if (!writeRegister(READ_MEASUREMENT)) {
+                ++_counter.bus_error;
+                _failures  = MAX_FAST_RETRY;
+                _probing   = false;
+                _next_read = at + _interval;
+                return;
+            }
+            Data d{};
+            if (readWithTransaction(d.raw.data(), d.raw.size()) != m5::hal::error::error_t::OK) {
+                // NACK, no new data yet. Delay the phase
+                if (_failures < MAX_FAST_RETRY) {
+                    ++_failures;
+                    if (_probing) {
+                        ++_counter.probe_miss;
+                    } else {
+                        ++_counter.not_ready;
+                    }
+                    _next_read = at + phase_step(_interval);
+                } else {
+                    // Not a phase error any more
+                    ++_counter.bus_error;
+                    _next_read = at + _interval;
+                }
+                _probing = false;
+                return;
+            }
+            _failures = 0;
+            _probing  = false;
+            if (!verify_measurement(d)) {
+                ++_counter.error;
+                _next_read = at + _interval;
+                return;
+            }
+            // Samples overwritten on the sensor while late
+            const elapsed_time_t late = (at > _next_read) ? (at - _next_read) / _interval : 0;
+            _counter.skipped += late;
+            _next_read += (late + 1) * _interval;
+            // Probe a little earlier in case the sensor is faster than us
+            if ((++_counter.read & 0x0F) == 0) {
+                _next_read -= phase_step(_interval);
+                _probing = true;
+            }
+            _updated = true;
+            _latest  = at;
+            preprocess(d, at);
+            _data->push_back(d);
+            postprocess(d);
+            // The pending bit stays until cleared, set again on the next measurement if the alert continues
+            if (alerted && !clearStatus()) {
+                M5_LIB_LOGW("Failed to clear the status");
             }
         }
     }
@@ -206,6 +288,10 @@ bool UnitSHT30::start_periodic_measurement(const sht30::MPS mps, const sht30::Re
         _rep      = rep;
         _interval = interval_table[m5::stl::to_underlying(mps)];
         m5::utility::delay(16);
+        // The first sample is ready one interval after the start
+        _next_read = m5::utility::millis() + _interval;
+        _failures  = 0;
+        _probing   = false;
         return true;
     }
     return _periodic;
@@ -233,6 +319,9 @@ bool UnitSHT30::writeModeAccelerateResponseTime()
     if (writeRegister(ACCELERATED_RESPONSE_TIME)) {
         _interval = 1000 / 4;  // 4mps
         m5::utility::delay(16);
+        _next_read = m5::utility::millis() + _interval;
+        _failures  = 0;
+        _probing   = false;
         return true;
     }
     return false;
@@ -254,6 +343,48 @@ bool UnitSHT30::clearStatus()
     return writeRegister(CLEAR_STATUS) && delay1();
 }
 
+bool UnitSHT30::watchAlert(const bool enable)
+{
+    // Clear the pending bit set on power-up and reset
+    if (enable && !clearStatus()) {
+        M5_LIB_LOGE("Failed to clear the status");
+        return false;
+    }
+    _watch_alert = enable;
+    _watched_at  = 0;
+    return true;
+}
+
+bool UnitSHT30::writeAlertLimit(const sht30::Alert alert, const float celsius, const float rh)
+{
+    constexpr uint16_t cmd[] = {WRITE_HIGH_ALERT_LIMIT_SET, WRITE_HIGH_ALERT_LIMIT_CLEAR, WRITE_LOW_ALERT_LIMIT_CLEAR,
+                                WRITE_LOW_ALERT_LIMIT_SET};
+    if (std::isnan(celsius) || std::isnan(rh)) {
+        M5_LIB_LOGE("Invalid arg");
+        return false;
+    }
+    m5::types::big_uint16_t limit(alert_limit_to_raw(celsius, rh));
+    std::array<uint8_t, 3> buf{};
+    std::memcpy(buf.data(), limit.data(), 2);
+    buf[2] = m5::utility::CRC8_Checksum().range(limit.data(), 2);
+    return writeRegister(cmd[m5::stl::to_underlying(alert)], buf.data(), buf.size()) && delay1();
+}
+
+bool UnitSHT30::readAlertLimit(const sht30::Alert alert, float& celsius, float& rh)
+{
+    constexpr uint16_t cmd[] = {READ_HIGH_ALERT_LIMIT_SET, READ_HIGH_ALERT_LIMIT_CLEAR, READ_LOW_ALERT_LIMIT_CLEAR,
+                                READ_LOW_ALERT_LIMIT_SET};
+    celsius = rh = std::numeric_limits<float>::quiet_NaN();
+
+    std::array<uint8_t, 3> rbuf{};
+    if (readRegister(cmd[m5::stl::to_underlying(alert)], rbuf.data(), rbuf.size(), 1) &&
+        m5::utility::CRC8_Checksum().range(rbuf.data(), 2) == rbuf[2]) {
+        raw_to_alert_limit(m5::types::big_uint16_t(rbuf[0], rbuf[1]).get(), celsius, rh);
+        return true;
+    }
+    return false;
+}
+
 bool UnitSHT30::softReset()
 {
     if (inPeriodic()) {
@@ -349,16 +480,18 @@ bool UnitSHT30::readSerialNumber(char* serialNumber)
 
 bool UnitSHT30::read_measurement(Data& d)
 {
-    if (readWithTransaction(d.raw.data(), d.raw.size()) == m5::hal::error::error_t::OK) {
-        m5::utility::CRC8_Checksum crc{};
-        for (uint_fast8_t i = 0; i < 2; ++i) {
-            if (crc.range(d.raw.data() + i * 3, 2U) != d.raw[i * 3 + 2]) {
-                return false;
-            }
+    return readWithTransaction(d.raw.data(), d.raw.size()) == m5::hal::error::error_t::OK && verify_measurement(d);
+}
+
+bool UnitSHT30::verify_measurement(const Data& d)
+{
+    m5::utility::CRC8_Checksum crc{};
+    for (uint_fast8_t i = 0; i < 2; ++i) {
+        if (crc.range(d.raw.data() + i * 3, 2U) != d.raw[i * 3 + 2]) {
+            return false;
         }
-        return true;
     }
-    return false;
+    return true;
 }
 
 }  // namespace unit
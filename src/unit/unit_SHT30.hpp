@@ -12,6 +12,7 @@
 
 #include <M5UnitComponent.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "processing_adapter.hpp"
 #include <limits>  // NaN
 
 namespace m5 {
@@ -86,11 +87,68 @@ struct Status {
     uint16_t value{};
 };
 
+/*!
+  @enum Alert
+  @brief Alert limits
+  @details The alert is set when the value goes over HighSet or under LowSet,
+  and cleared when it goes back under HighClear or over LowClear
+ */
+enum class Alert : uint8_t {
+    HighSet,    //!< @brief High alert limit to set
+    HighClear,  //!< @brief High alert limit to clear
+    LowClear,   //!< @brief Low alert limit to clear
+    LowSet,     //!< @brief Low alert limit to set
+};
+
+/*!
+  @brief Encode the alert limit
+  @param celsius Temperature (Celsius)
+  @param rh Humidity (RH)
+  @return Limit value (7 MSBs of RH and 9 MSBs of temperature)
+ */
+uint16_t alert_limit_to_raw(const float celsius, const float rh);
+/*!
+  @brief Decode the alert limit
+  @param raw Limit value
+  @param[out] celsius Temperature (Celsius)
+  @param[out] rh Humidity (RH)
+ */
+void raw_to_alert_limit(const uint16_t raw, float& celsius, float& rh);
+
+/*!
+  @struct Counter
+  @brief Statistics of the periodic reads
+ */
+struct Counter {
+    uint32_t read{};        //!< @brief Samples read
+    uint32_t probe_miss{};  //!< @brief Early probe reads answered by NACK (expected, the phase is right)
+    uint32_t not_ready{};   //!< @brief Scheduled reads answered by NACK since no new data (the phase is early)
+    uint32_t skipped{};     //!< @brief Samples overwritten on the sensor before being read
+    uint32_t error{};       //!< @brief Reads failed by CRC mismatch
+    uint32_t bus_error{};   //!< @brief Reads failed after the fast retries, or the command failed
+};
+
+/*!
+  @enum Field
+  @brief Scalar fields of the measurement data
+ */
+enum class Field : uint8_t {
+    Temperature,  //!< Temperature (Celsius)
+    Humidity,     //!< Humidity (RH)
+};
+
+//! @brief Statistics of the fields
+using Statistics = statistics::Statistics<Field, 2>;
+//! @brief Change detection of the fields
+using Deadband = deadband::Deadband<Field, 2>;
+//! @brief Software filters of the fields
+using FilterPipeline = filter::Pipeline<Field, 2>;
+
 /*!
   @struct Data
   @brief Measurement data group
  */
-struct Data {
+struct Data : processing::Sample<Field, 2> {
     std::array<uint8_t, 6> raw{};  //!< RAW data
     //! temperature (Celsius)
     inline float temperature() const
@@ -100,6 +158,11 @@ struct Data {
     float celsius() const;     //!< temperature (Celsius)
     float fahrenheit() const;  //!< temperature (Fahrenheit)
     float humidity() const;    //!< humidity (RH)
+    //! @brief Values of the fields in the order of Field
+    inline Statistics::values_t values() const
+    {
+        return {{celsius(), humidity()}};
+    }
 };
 
 }  // namespace sht30
@@ -108,7 +171,9 @@ struct Data {
   @class UnitSHT30
   @brief Temperature and humidity, sensor unit
 */
-class UnitSHT30 : public Component, public PeriodicMeasurementAdapter<UnitSHT30, sht30::Data> {
+class UnitSHT30 : public Component,
+                  public PeriodicMeasurementAdapter<UnitSHT30, sht30::Data>,
+                  public ProcessingAdapter<UnitSHT30, sht30::Data, sht30::Field, 2> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitSHT30, 0x44);
 
 public:
@@ -208,6 +273,21 @@ public:
     {
         return PeriodicMeasurementAdapter<UnitSHT30, sht30::Data>::stopPeriodicMeasurement();
     }
+    /*!
+      @brief Gets the statistics of the periodic reads
+      @details Reads are scheduled in phase with the sensor; a NACK delays the phase
+      and every 16th read probes a little earlier, so that each sample is read once.
+      After consecutive failures the read is retried at the interval instead of the phase step
+     */
+    inline const sht30::Counter& counter() const
+    {
+        return _counter;
+    }
+    //! @brief Reset the statistics
+    inline void resetCounter()
+    {
+        _counter = {};
+    }
     ///@}
 
     ///@name Single shot measurement
@@ -287,6 +367,44 @@ public:
     bool clearStatus();
     ///@}
 
+    ///@name Alert
+    ///@{
+    /*!
+      @brief Write the alert limit
+      @param alert Limit to write
+      @param celsius Temperature (Celsius)
+      @param rh Humidity (RH)
+      @return True if successful
+      @note Resolution is 7 bits for humidity (0.8 %RH) and 9 bits for temperature (0.35 Celsius)
+      @note Alerts are evaluated on each periodic measurement
+    */
+    bool writeAlertLimit(const sht30::Alert alert, const float celsius, const float rh);
+    /*!
+      @brief Read the alert limit
+      @param alert Limit to read
+      @param[out] celsius Temperature (Celsius)
+      @param[out] rh Humidity (RH)
+      @return True if successful
+    */
+    bool readAlertLimit(const sht30::Alert alert, float& celsius, float& rh);
+    /*!
+      @brief Watch the alert
+      @details If enabled, update reads only the status on each interval and
+      fetches the measurement data only when an alert is pending
+      @param enable Enable if true
+      @return True if successful
+      @note The alert pending bit is set after power-up and reset and stays until cleared,
+      so the status is cleared on enabling and after each pending alert is fetched
+      @note The data is not updated while no alert is pending
+    */
+    bool watchAlert(const bool enable);
+    //! @brief Is the alert watched?
+    inline bool watchingAlert() const
+    {
+        return _watch_alert;
+    }
+    ///@}
+
     ///@name Serial number
     ///@{
     /*!
@@ -315,6 +433,7 @@ protected:
     }
     bool stop_periodic_measurement();
     bool read_measurement(sht30::Data& d);
+    static bool verify_measurement(const sht30::Data& d);
 
     M5_UNIT_COMPONENT_PERIODIC_MEASUREMENT_ADAPTER_HPP_BUILDER(UnitSHT30, sht30::Data);
 
@@ -323,6 +442,12 @@ protected:
     config_t _cfg{};
     sht30::MPS _mps{};
     sht30::Repeatability _rep{};
+    bool _watch_alert{};
+    types::elapsed_time_t _watched_at{};
+    types::elapsed_time_t _next_read{};  // Scheduled time of the next read
+    sht30::Counter _counter{};
+    uint8_t _failures{};  // Consecutive failed reads
+    bool _probing{};      // The next read is the early probe
 };
 
 ///@cond
@@ -367,6 +492,15 @@ constexpr uint16_t STOP_HEATER{0x3066};
 // Status
 constexpr uint16_t READ_STATUS{0xF32D};
 constexpr uint16_t CLEAR_STATUS{0x3041};
+// Alert
+constexpr uint16_t READ_HIGH_ALERT_LIMIT_SET{0xE11F};
+constexpr uint16_t READ_HIGH_ALERT_LIMIT_CLEAR{0xE114};
+constexpr uint16_t READ_LOW_ALERT_LIMIT_CLEAR{0xE109};
+constexpr uint16_t READ_LOW_ALERT_LIMIT_SET{0xE102};
+constexpr uint16_t WRITE_HIGH_ALERT_LIMIT_SET{0x611D};
+constexpr uint16_t WRITE_HIGH_ALERT_LIMIT_CLEAR{0x6116};
+constexpr uint16_t WRITE_LOW_ALERT_LIMIT_CLEAR{0x610B};
+constexpr uint16_t WRITE_LOW_ALERT_LIMIT_SET{0x6100};
 // Serial
 constexpr uint16_t GET_SERIAL_NUMBER_ENABLE_STRETCH{0x3780};
 constexpr uint16_t GET_SERIAL_NUMBER_DISABLE_STRETCH{0x3682};
@@ -11,6 +11,7 @@
 #include <M5Utility.hpp>
 #include <limits>  // NaN
 #include <array>
+#include <cmath>
 
 using namespace m5::utility::mmh3;
 using namespace m5::unit::types;
@@ -99,6 +100,7 @@ bool UnitSHT40::begin()
     _precision = _cfg.precision;
     _heater    = _cfg.heater;
     _duty      = _cfg.heater_duty;
+    _policy    = _cfg.heater_policy;
     return _cfg.start_periodic ? startPeriodicMeasurement(_cfg.precision, _cfg.heater, _cfg.heater_duty) : true;
 }
 
@@ -112,15 +114,34 @@ void UnitSHT40::update(const bool force)
             _updated = read_measurement(d);
 
             if (_updated) {
-                _latest  = at;
-                d.heater = (_interval != _duration_heater);
+                _latest    = at;
+                d.heater   = _heating;
+                d.recovery = !_heating && at < _recovery_until;
+                // Samples affected by the heater are not filtered and not reported
+                preprocess(d, at, !d.affected());
                 _data->push_back(d);
+                postprocess(d, !d.affected());
+
+                ++_heater_stats.samples;
+                _heater_stats.elapsed = at - _started;
+                if (d.heater) {
+                    ++_heater_stats.heater;
+                    _recovery_until = at + _active_policy.recovery;
+                }
+                if (d.recovery) {
+                    ++_heater_stats.recovery;
+                }
+                track_plateau(d);
 
                 uint8_t cmd{};
-                if (at >= _latest_heater + _interval_heater) {
+                _heating = heater_due(at, d);
+                if (_heating) {
                     cmd            = _cmd;
                     _latest_heater = at;
+                    _heated        = true;
                     _interval      = _duration_heater;
+                    _plateau_count = 0;
+                    count_pulse();
                 } else {
                     cmd       = _measureCmd;
                     _interval = _duration_measure;
@@ -149,7 +170,10 @@ bool UnitSHT40::start_periodic_measurement(const sht40::Precision precision, con
     _cmd        = periodic_cmd[m5::stl::to_underlying(precision) * 3 + m5::stl::to_underlying(heater)];
     _measureCmd = periodic_cmd[m5::stl::to_underlying(precision) * 3 + m5::stl::to_underlying(Heater::None)];
 
-    _periodic = writeRegister(_cmd);
+    // Only the fixed duty starts with the heater
+    const bool heating = (heater != Heater::None) && _policy.trigger == HeaterTrigger::Duty;
+
+    _periodic = writeRegister(heating ? _cmd : _measureCmd);
     if (_periodic) {
         _precision       = precision;
         _heater          = heater;
@@ -159,8 +183,17 @@ bool UnitSHT40::start_periodic_measurement(const sht40::Precision precision, con
             interval_table[m5::stl::to_underlying(precision) * 3 + m5::stl::to_underlying(Heater::None)];
 
         _interval_heater = _duration_heater / duty;
-        _interval        = _duration_heater;
+        _interval        = heating ? _duration_heater : _duration_measure;
         _latest_heater   = m5::utility::millis();
+        _heating = _heated = heating;
+        _recovery_until    = 0;
+        _plateau_count     = 0;
+        _active_policy     = _policy;
+
+        resetHeaterStatistics();
+        if (heating) {
+            count_pulse();
+        }
 
         m5::utility::delay(_interval);  // For first read_measurement in update
         return true;
@@ -185,6 +218,55 @@ bool UnitSHT40::stop_periodic_measurement()
     return false;
 }
 
+void UnitSHT40::resetHeaterStatistics()
+{
+    _heater_stats = {};
+    _started      = m5::utility::millis();
+}
+
+void UnitSHT40::count_pulse()
+{
+    // Measurements that could have been made while heating
+    ++_heater_stats.pulses;
+    _heater_stats.heating += _duration_heater;
+    _heater_stats.lost    += _duration_heater / _duration_measure - 1;
+}
+
+bool UnitSHT40::heater_due(const elapsed_time_t at, const sht40::Data& d) const
+{
+    if (_heater == Heater::None || (_heated && at < _latest_heater + _interval_heater)) {
+        return false;
+    }
+    switch (_active_policy.trigger) {
+        case HeaterTrigger::Humidity:
+            // Humidity just after the heater is lower than actual
+            return !d.affected() && d.humidity() >= _active_policy.humidity;
+        case HeaterTrigger::Plateau:
+            return _plateau_count >= _active_policy.plateau_samples;
+        default:
+            return true;
+    }
+}
+
+void UnitSHT40::track_plateau(const sht40::Data& d)
+{
+    if (d.affected()) {
+        return;
+    }
+    const float rh = d.humidity();
+    // Only near saturation, a stable room below the threshold is not a plateau
+    if (!(rh >= _active_policy.humidity)) {
+        _plateau_count = 0;
+        return;
+    }
+    if (_plateau_count && std::fabs(rh - _plateau_anchor) <= _active_policy.plateau_band) {
+        _plateau_count += (_plateau_count < 0xFFFF);
+        return;
+    }
+    _plateau_anchor = rh;
+    _plateau_count  = 1;
+}
+
 bool UnitSHT40::measureSingleshot(sht40::Data& d, const sht40::Precision precision, const sht40::Heater heater)
 {
     if (inPeriodic()) {
@@ -295,6 +377,7 @@ void UnitSHT40::reset_status()
     _interval = _latest = _interval_heater = _latest_heater = 0;
     _duration_measure = _duration_heater = 0;
     _cmd = _measureCmd = 0;
+    _heating = _heated = false;
     _periodic          = false;
 }
 
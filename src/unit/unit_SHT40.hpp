@@ -12,6 +12,7 @@
 
 #include <M5UnitComponent.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "processing_adapter.hpp"
 #include <limits>  // NaN
 
 namespace m5 {
@@ -43,13 +44,91 @@ enum class Heater : uint8_t {
     None    //!< Not activate heater
 };
 
+/*!
+  @enum HeaterTrigger
+  @brief Condition to activate the heater in periodic measurement
+ */
+enum class HeaterTrigger : uint8_t {
+    Duty,      //!< Periodically within the duty (default)
+    Humidity,  //!< When the humidity is at or above the threshold
+    Plateau,   //!< When the humidity stays within the band at or above the threshold (stuck near saturation)
+};
+
+/*!
+  @struct HeaterPolicy
+  @brief Policy to schedule the heater pulses in periodic measurement
+  @details HeaterTrigger::Plateau counts only the samples at or above humidity,
+  so a stable room below it never fires and a sensor stuck near saturation (creep or condensation) does
+  @note Pulses are never closer than the heater duration / duty, whatever the trigger
+ */
+struct HeaterPolicy {
+    //! Condition to activate the heater
+    HeaterTrigger trigger{HeaterTrigger::Duty};
+    //! Threshold of humidity (%RH) for HeaterTrigger::Humidity and HeaterTrigger::Plateau
+    float humidity{80.0f};
+    //! Number of consecutive samples within plateau_band at or above humidity for HeaterTrigger::Plateau
+    uint16_t plateau_samples{64};
+    //! Width of humidity (%RH) regarded as a plateau
+    float plateau_band{0.5f};
+    //! Time (ms) after the heater during which samples are marked as recovery
+    uint32_t recovery{3000};
+};
+
+/*!
+  @struct HeaterStatistics
+  @brief Statistics of the heater in periodic measurement
+ */
+struct HeaterStatistics {
+    uint32_t samples{};   //!< Number of samples stored
+    uint32_t pulses{};    //!< Number of heater pulses
+    uint32_t heater{};    //!< Samples measured at the end of the heater pulse
+    uint32_t recovery{};  //!< Samples measured while recovering from the heater
+    uint32_t lost{};      //!< Samples not measured while the heater is active
+    uint32_t heating{};   //!< Total heater time (ms)
+    uint32_t elapsed{};   //!< Time (ms) since the start of periodic measurement
+
+    //! @brief Effective heater duty
+    inline float duty() const
+    {
+        return elapsed ? (float)heating / elapsed : 0.0f;
+    }
+    //! @brief Ratio of the samples lost or not usable for the statistics due to the heater
+    inline float lostRatio() const
+    {
+        return (samples + lost) ? (float)(lost + heater + recovery) / (samples + lost) : 0.0f;
+    }
+};
+
+/*!
+  @enum Field
+  @brief Scalar fields of the measurement data
+ */
+enum class Field : uint8_t {
+    Temperature,  //!< Temperature (Celsius)
+    Humidity,     //!< Humidity (RH)
+};
+
+//! @brief Statistics of the fields
+using Statistics = statistics::Statistics<Field, 2>;
+//! @brief Change detection of the fields
+using Deadband = deadband::Deadband<Field, 2>;
+//! @brief Software filters of the fields
+using FilterPipeline = filter::Pipeline<Field, 2>;
+
 /*!
   @struct Data
   @brief Measurement data group
  */
-struct Data {
+struct Data : processing::Sample<Field, 2> {
     std::array<uint8_t, 6> raw{};  //!< RAW data
     bool heater{};                 //!< Measured data after heater is activated if true
+    bool recovery{};               //!< Measured data while recovering from the heater if true
+
+    //! @brief Affected by the heater? (should be excluded from statistics)
+    inline bool affected() const
+    {
+        return heater || recovery;
+    }
 
     //! temperature (Celsius)
     inline float temperature() const
@@ -59,6 +138,11 @@ struct Data {
     float celsius() const;     //!< temperature (Celsius)
     float fahrenheit() const;  //!< temperature (Fahrenheit)
     float humidity() const;    //!< humidity (RH)
+    //! @brief Values of the fields in the order of Field
+    inline Statistics::values_t values() const
+    {
+        return {{celsius(), humidity()}};
+    }
 };
 
 }  // namespace sht40
@@ -67,7 +151,9 @@ struct Data {
   @class UnitSHT40
   @brief Temperature and humidity, sensor unit
 */
-class UnitSHT40 : public Component, public PeriodicMeasurementAdapter<UnitSHT40, sht40::Data> {
+class UnitSHT40 : public Component,
+                  public PeriodicMeasurementAdapter<UnitSHT40, sht40::Data>,
+                  public ProcessingAdapter<UnitSHT40, sht40::Data, sht40::Field, 2> {
     M5_UNIT_COMPONENT_HPP_BUILDER(UnitSHT40, 0x44);
 
 public:
@@ -84,6 +170,8 @@ public:
         sht40::Heater heater{sht40::Heater::None};
         //! Heater duty cycle if start on begin [~ 0.05f]
         float heater_duty{0.05f};
+        //! Heater policy
+        sht40::HeaterPolicy heater_policy{};
     };
 
     explicit UnitSHT40(const uint8_t addr = DEFAULT_ADDRESS)
@@ -173,6 +261,34 @@ public:
     }
     ///@}
 
+    ///@name Heater policy
+    ///@{
+    //! @brief Gets the heater policy (set one, may not be applied yet)
+    inline const sht40::HeaterPolicy& heaterPolicy() const
+    {
+        return _policy;
+    }
+    /*!
+      @brief Set the heater policy
+      @param policy Policy
+      @note Applied from the next startPeriodicMeasurement, the running measurement keeps the one at its start
+     */
+    inline void heaterPolicy(const sht40::HeaterPolicy& policy)
+    {
+        _policy = policy;
+    }
+    /*!
+      @brief Gets the heater statistics
+      @note Reset on startPeriodicMeasurement
+     */
+    inline const sht40::HeaterStatistics& heaterStatistics() const
+    {
+        return _heater_stats;
+    }
+    //! @brief Reset the heater statistics
+    void resetHeaterStatistics();
+    ///@}
+
     ///@name Single shot measurement
     ///@{
     /*!
@@ -235,6 +351,9 @@ protected:
     bool read_measurement(sht40::Data& d);
     void reset_status();
     bool soft_reset();
+    bool heater_due(const types::elapsed_time_t at, const sht40::Data& d) const;
+    void track_plateau(const sht40::Data& d);
+    void count_pulse();
 
     M5_UNIT_COMPONENT_PERIODIC_MEASUREMENT_ADAPTER_HPP_BUILDER(UnitSHT40, sht40::Data);
 
@@ -243,6 +362,12 @@ protected:
     uint8_t _cmd{}, _measureCmd{};
     types::elapsed_time_t _latest_heater{}, _interval_heater{};
     uint32_t _duration_measure{}, _duration_heater{};
+    types::elapsed_time_t _started{}, _recovery_until{};
+    bool _heating{}, _heated{};
+    float _plateau_anchor{};
+    uint16_t _plateau_count{};
+    sht40::HeaterPolicy _policy{}, _active_policy{};
+    sht40::HeaterStatistics _heater_stats{};
 
 private:
     config_t _cfg{};
@@ -13,6 +13,7 @@
 #include <googletest/test_helper.hpp>
 #include <googletest/test_template.hpp>
 #include <unit/unit_BME688.hpp>
+#include <unit/scd4x_pressure_compensator.hpp>
 #include <chrono>
 #include <random>
 #include <set>
@@ -20,6 +21,7 @@
 using namespace m5::unit::googletest;
 using namespace m5::unit;
 using namespace m5::unit::bme688;
+using m5::unit::types::elapsed_time_t;
 #if defined(UNIT_BME688_USING_BSEC2)
 using namespace m5::unit::bme688::bsec2;
 #endif
@@ -87,6 +89,10 @@ void check_measurement_values(UnitBME688* u)
     EXPECT_TRUE(std::isfinite(latest.raw_pressure()));
     EXPECT_TRUE(std::isfinite(latest.raw_humidity()));
     EXPECT_TRUE(std::isfinite(latest.raw_gas()));
+    // Pa in both update paths (with and without BSEC2)
+    EXPECT_GT(latest.raw_pressure(), 30000.0f);
+    EXPECT_LT(latest.raw_pressure(), 110000.0f);
+    EXPECT_FLOAT_EQ(m5::unit::scd4x::pressure_hPa(latest), latest.raw_pressure() * 0.01f);
     // M5_LOGI("%f/%f/%f/%f", latest.raw_temperature(), latest.raw_pressure(), latest.raw_humidity(), latest.raw_gas());
 }
 
@@ -407,6 +413,139 @@ TEST_F(TestBME688, BSEC2)
         M5_DUMPI(state2, actual);
     }
 }
+
+TEST_F(TestBME688, ShadowCounter)
+{
+    SCOPED_TRACE(ustr);
+
+    constexpr bsec_virtual_sensor_t sensorList[] = {BSEC_OUTPUT_IAQ, BSEC_OUTPUT_RAW_TEMPERATURE,
+                                                    BSEC_OUTPUT_RAW_PRESSURE, BSEC_OUTPUT_RAW_HUMIDITY,
+                                                    BSEC_OUTPUT_RAW_GAS};
+
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(unit->inPeriodic());
+
+    // Other heater than BSEC2 requests, so the first forced cycle must write everything
+    m5::unit::bme688::bme68xHeatrConf hs{};
+    hs.enable     = true;
+    hs.heatr_temp = 200;
+    hs.heatr_dur  = 50;
+    EXPECT_TRUE(unit->writeHeaterSetting(Mode::Forced, hs));
+
+    const auto prev = unit->bsec2ShadowCounter();
+
+    // LowPower runs in forced mode with the same settings every cycle
+    EXPECT_TRUE(unit->startPeriodicMeasurement(sensorList, m5::stl::size(sensorList), bsec2::SampleRate::LowPower));
+    {
+        auto timeout = (unit->interval() * 2) * 6;
+        auto r       = collect_periodic_measurements(unit.get(), 6, timeout, check_measurement_values);
+        EXPECT_FALSE(r.timed_out);
+        EXPECT_EQ(r.update_count, 6U);
+    }
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+
+    const auto& sc          = unit->bsec2ShadowCounter();
+    const uint32_t full     = sc.full - prev.full;
+    const uint32_t triggers = sc.trigger_only - prev.trigger_only;
+    const uint32_t saved    = sc.saved - prev.saved;
+    // M5_LOGI("full:%u trigger:%u saved:%u", full, triggers, saved);
+    EXPECT_EQ(full, 1U);  // Only the first cycle after the heater was changed
+    EXPECT_GE(full + triggers, 6U);
+    // Each trigger only cycle saves the oversampling and heater writes
+    EXPECT_GE(saved, triggers * 2);
+
+    // Outputs are still obtained by trigger only cycles
+    EXPECT_FALSE(unit->empty());
+    while (unit->available()) {
+        EXPECT_TRUE(std::isfinite(unit->oldest().iaq()));
+        EXPECT_TRUE(std::isfinite(unit->oldest().raw_gas()));
+        unit->discard();
+    }
+}
+
+TEST_F(TestBME688, Jitter)
+{
+    SCOPED_TRACE(ustr);
+
+    constexpr bsec_virtual_sensor_t sensorList[] = {BSEC_OUTPUT_IAQ, BSEC_OUTPUT_RAW_TEMPERATURE,
+                                                    BSEC_OUTPUT_RAW_PRESSURE, BSEC_OUTPUT_RAW_HUMIDITY,
+                                                    BSEC_OUTPUT_RAW_GAS};
+    const uint32_t tolerance = unit->config().lateness_tolerance;
+
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    unit->bsec2ResetJitter();
+    EXPECT_EQ(unit->bsec2Jitter().count, 0U);
+    EXPECT_EQ(unit->bsec2Jitter().max, 0U);
+    EXPECT_EQ(unit->bsec2Jitter().mean(), 0U);
+
+    // Updated without delay, every call is on the schedule
+    EXPECT_TRUE(unit->startPeriodicMeasurement(sensorList, m5::stl::size(sensorList), bsec2::SampleRate::LowPower));
+    {
+        auto timeout = (unit->interval() * 2) * 4;
+        auto r       = collect_periodic_measurements(unit.get(), 4, timeout, check_measurement_values);
+        EXPECT_FALSE(r.timed_out);
+        EXPECT_EQ(r.update_count, 4U);
+        EXPECT_LE(r.median(), r.expected_interval + 8);
+    }
+    {
+        auto j = unit->bsec2Jitter();
+        // M5_LOGI("count:%u violations:%u last:%u max:%u mean:%u", j.count, j.violations, j.last, j.max, j.mean());
+        EXPECT_GE(j.count, 3U);  // The first call after start is not scheduled
+        EXPECT_EQ(j.violations, 0U);
+        EXPECT_LE(j.last, j.max);
+        EXPECT_LE(j.mean(), j.max);
+        EXPECT_LE(j.max, tolerance);
+    }
+
+    // Late beyond the tolerance, but within the timing violation of BSEC2 (6.25% of the sample interval)
+    {
+        constexpr uint32_t TOLERANCE_MS{20};
+        constexpr uint32_t LATE_MS{60};
+        auto cfg               = unit->config();
+        cfg.lateness_tolerance = TOLERANCE_MS * 1000U;
+        unit->config(cfg);
+
+        // The call on the schedule
+        elapsed_time_t called_at{};
+        auto timeout_at = m5::utility::millis() + unit->interval() * 2;
+        do {
+            called_at = m5::utility::millis();
+            unit->update();
+            if (unit->updated()) {
+                break;
+            }
+            m5::utility::delay(1);
+        } while (called_at <= timeout_at);
+        EXPECT_TRUE(unit->updated());
+
+        auto prev    = unit->bsec2Jitter();
+        auto late_at = called_at + unit->interval() + LATE_MS;
+        while (m5::utility::millis() < late_at) {
+            m5::utility::delay(1);
+        }
+        unit->update();
+
+        auto j = unit->bsec2Jitter();
+        EXPECT_EQ(j.count, prev.count + 1);
+        EXPECT_EQ(j.violations, 1U);
+        EXPECT_GT(j.last, TOLERANCE_MS * 1000U);
+        EXPECT_LT(j.last, unit->interval() * 1000U / 16);
+        EXPECT_GE(j.max, j.last);
+
+        // The next calls are on the schedule from the late call
+        auto r = collect_periodic_measurements(unit.get(), 2, (unit->interval() * 2) * 2, check_measurement_values);
+        EXPECT_FALSE(r.timed_out);
+        j = unit->bsec2Jitter();
+        EXPECT_EQ(j.violations, 1U);
+        EXPECT_LE(j.last, TOLERANCE_MS * 1000U);
+    }
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+
+    unit->bsec2ResetJitter();
+    EXPECT_EQ(unit->bsec2Jitter().count, 0U);
+    EXPECT_EQ(unit->bsec2Jitter().violations, 0U);
+    EXPECT_EQ(unit->bsec2Jitter().total, 0U);
+}
 #endif
 
 TEST_F(TestBME688, SingleShot)
@@ -450,6 +589,104 @@ TEST_F(TestBME688, SingleShot)
 #endif
 }
 
+TEST_F(TestBME688, SingleShotNonBlocking)
+{
+    SCOPED_TRACE(ustr);
+
+    constexpr elapsed_time_t TIMEOUT{100};  // Same as pollSingleShot
+
+    bme68xConf tph{};
+    tph.os_temp = m5::stl::to_underlying(Oversampling::x2);
+    tph.os_pres = m5::stl::to_underlying(Oversampling::x1);
+    tph.os_hum  = m5::stl::to_underlying(Oversampling::x16);
+    tph.filter  = m5::stl::to_underlying(Filter::None);
+    tph.odr     = m5::stl::to_underlying(ODR::None);
+    EXPECT_TRUE(unit->writeTPHSetting(tph));
+
+    m5::unit::bme688::bme68xHeatrConf hs{};
+    hs.enable     = true;
+    hs.heatr_temp = 300;
+    hs.heatr_dur  = 100;
+    EXPECT_TRUE(unit->writeHeaterSetting(Mode::Forced, hs));
+
+    bme68xData data{};
+    elapsed_time_t deadline{};
+
+    EXPECT_TRUE(unit->inPeriodic());
+    EXPECT_FALSE(unit->startSingleShot(deadline));
+    EXPECT_EQ(deadline, 0U);
+    EXPECT_FALSE(unit->inSingleShot());
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+
+    EXPECT_FALSE(unit->pollSingleShot(data));  // Not triggered
+
+    // Completed at or after the deadline
+    {
+        auto start = m5::utility::millis();
+        EXPECT_TRUE(unit->startSingleShot(deadline));
+        EXPECT_TRUE(unit->inSingleShot());
+        EXPECT_GE(deadline, start + hs.heatr_dur);
+        EXPECT_FALSE(unit->pollSingleShot(data));  // Before the deadline
+        EXPECT_TRUE(unit->inSingleShot());
+
+        bool done{};
+        elapsed_time_t now{};
+        do {
+            now  = m5::utility::millis();
+            done = unit->pollSingleShot(data);
+            if (done) {
+                break;
+            }
+            m5::utility::delay(1);
+        } while (unit->inSingleShot() && now <= deadline + TIMEOUT * 2);
+        EXPECT_TRUE(done);
+        EXPECT_GE(now, deadline);
+        EXPECT_FALSE(unit->inSingleShot());
+        EXPECT_TRUE(std::isfinite(data.temperature));
+        EXPECT_TRUE(std::isfinite(data.humidity));
+        EXPECT_GT(data.pressure, 30000.0f);
+        EXPECT_LT(data.pressure, 110000.0f);
+    }
+
+    // Timeout if the new data never comes (measurement aborted by sleep)
+    {
+        EXPECT_TRUE(unit->startSingleShot(deadline));
+        EXPECT_TRUE(unit->writeMode(Mode::Sleep));
+        EXPECT_TRUE(unit->inSingleShot());
+
+        bool done{};
+        elapsed_time_t now{}, gave_up{};
+        do {
+            now  = m5::utility::millis();
+            done = unit->pollSingleShot(data);
+            if (!unit->inSingleShot()) {
+                gave_up = now;
+                break;
+            }
+            m5::utility::delay(1);
+        } while (now <= deadline + TIMEOUT * 2);
+        EXPECT_FALSE(done);
+        EXPECT_FALSE(unit->inSingleShot());
+        EXPECT_GE(gave_up, deadline + TIMEOUT);
+        EXPECT_LE(gave_up, deadline + TIMEOUT + 20);
+        EXPECT_FALSE(unit->pollSingleShot(data));  // Already given up
+    }
+
+    // Periodic measurement started after the trigger overrides it
+    {
+        EXPECT_TRUE(unit->startSingleShot(deadline));
+        EXPECT_TRUE(unit->startPeriodicMeasurement(Mode::Forced));
+        EXPECT_FALSE(unit->startSingleShot(deadline));
+        EXPECT_FALSE(unit->pollSingleShot(data));
+        EXPECT_FALSE(unit->inSingleShot());
+        EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    }
+
+    // The blocking one is still available
+    EXPECT_TRUE(unit->measureSingleShot(data));
+    EXPECT_FALSE(unit->inSingleShot());
+}
+
 TEST_F(TestBME688, PeriodicForced)
 {
     SCOPED_TRACE(ustr);
@@ -643,6 +880,115 @@ TEST_F(TestBME688, PeriodicSequential)
     EXPECT_EQ(unit->mode(), Mode::Sleep);
 }
 
+TEST_F(TestBME688, Sequencer)
+{
+    SCOPED_TRACE(ustr);
+
+    EXPECT_TRUE(unit->inPeriodic());
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(unit->inPeriodic());
+
+    bme68xConf tph{};
+    tph.os_temp = m5::stl::to_underlying(Oversampling::x2);
+    tph.os_pres = m5::stl::to_underlying(Oversampling::x1);
+    tph.os_hum  = m5::stl::to_underlying(Oversampling::x16);
+    tph.filter  = m5::stl::to_underlying(Filter::None);
+    tph.odr     = m5::stl::to_underlying(ODR::None);
+    EXPECT_TRUE(unit->writeTPHSetting(tph));
+
+    // 3 steps each, so that a read of the 3 fields never contains 2 last steps
+    const uint16_t shared = 140 - (unit->calculateMeasurementInterval(Mode::Parallel, tph) / 1000);
+    HeaterProfile profiles[2]{};
+    profiles[0].name                    = "parallel";
+    profiles[0].mode                    = Mode::Parallel;
+    profiles[0].heater.enable           = true;
+    profiles[0].heater.profile_len      = 3;
+    profiles[0].heater.shared_heatr_dur = shared;
+    profiles[0].scans                   = 3;
+    profiles[1].name                    = "sequential";
+    profiles[1].mode                    = Mode::Sequential;
+    profiles[1].heater.enable           = true;
+    profiles[1].heater.profile_len      = 3;
+    profiles[1].scans                   = 2;
+    constexpr uint16_t par_temp[3] = {320, 100, 200};
+    constexpr uint16_t par_mul[3]  = {2, 1, 2};
+    constexpr uint16_t seq_temp[3] = {200, 280, 360};
+    constexpr uint16_t seq_dur[3]  = {100, 100, 100};
+    memcpy(profiles[0].heater.temp_prof, par_temp, sizeof(par_temp));
+    memcpy(profiles[0].heater.dur_prof, par_mul, sizeof(par_mul));
+    memcpy(profiles[1].heater.temp_prof, seq_temp, sizeof(seq_temp));
+    memcpy(profiles[1].heater.dur_prof, seq_dur, sizeof(seq_dur));
+
+    // Invalid
+    {
+        EXPECT_FALSE(unit->startPeriodicMeasurement(nullptr, 2));
+        EXPECT_FALSE(unit->startPeriodicMeasurement(profiles, 0));
+        HeaterProfile invalid = profiles[0];
+        invalid.scans         = 0;
+        EXPECT_FALSE(unit->startPeriodicMeasurement(&invalid, 1));
+        invalid       = profiles[0];
+        invalid.mode  = Mode::Forced;
+        EXPECT_FALSE(unit->startPeriodicMeasurement(&invalid, 1));
+        EXPECT_FALSE(unit->inPeriodic());
+        EXPECT_EQ(unit->currentProfile(), nullptr);
+    }
+
+    EXPECT_TRUE(unit->startPeriodicMeasurement(profiles, 2));
+    EXPECT_TRUE(unit->inPeriodic());
+    ASSERT_NE(unit->currentProfile(), nullptr);
+    EXPECT_STREQ(unit->currentProfile()->name, "parallel");
+    EXPECT_GT(unit->profileDuration(), 0U);
+    EXPECT_LE(unit->interval(), unit->profileDuration());
+
+    // Collect until the sequencer comes back to the first profile
+    struct Sample {
+        uint8_t profile, step, meas_index;
+    };
+    std::vector<Sample> samples{};
+    std::vector<uint8_t> runs{};  // Profile index of each run
+    auto timeout_at = m5::utility::millis() + 60 * 1000;
+    while (runs.size() < 3 && m5::utility::millis() <= timeout_at) {
+        unit->update();
+        while (unit->available()) {
+            auto d = unit->oldest();
+            EXPECT_TRUE(std::isfinite(d.raw_temperature()));
+            EXPECT_TRUE(std::isfinite(d.raw_pressure()));
+            EXPECT_LT(d.step(), 3);
+            EXPECT_EQ(d.step(), d.raw.gas_index);
+            samples.push_back({d.profile, d.step(), d.raw.meas_index});
+            if (runs.empty() || runs.back() != d.profile) {
+                runs.push_back(d.profile);
+            }
+            unit->discard();
+        }
+        m5::utility::delay(1);
+    }
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(unit->inPeriodic());
+    EXPECT_EQ(unit->currentProfile(), nullptr);
+    EXPECT_EQ(unit->profileDuration(), 0U);
+
+    ASSERT_EQ(runs.size(), 3U);
+    EXPECT_EQ(runs[0], 0);
+    EXPECT_EQ(runs[1], 1);
+    EXPECT_EQ(runs[2], 0);
+
+    // Each scan is counted once even if the same field is read again (same meas_index)
+    uint32_t scans[2]{};
+    size_t run{};
+    int16_t counted{-1};
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto& s = samples[i];
+        run += (i && s.profile != samples[i - 1].profile);
+        if (run < 2 && s.step == 2 && s.meas_index != counted) {
+            ++scans[s.profile];
+            counted = s.meas_index;
+        }
+    }
+    EXPECT_EQ(scans[0], profiles[0].scans);
+    EXPECT_EQ(scans[1], profiles[1].scans);
+}
+
 TEST_F(TestBME688, SelfTest)
 {
     SCOPED_TRACE(ustr);
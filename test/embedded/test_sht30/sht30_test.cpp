@@ -282,6 +282,49 @@ TEST_F(TestSHT30, Periodic)
     EXPECT_GT(diff, 250);  // 2mps(500) > 4mps(250)
 }
 
+TEST_F(TestSHT30, Counter)
+{
+    SCOPED_TRACE(ustr);
+
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_TRUE(unit->startPeriodicMeasurement(MPS::Ten, Repeatability::High));
+    EXPECT_TRUE(unit->inPeriodic());
+    unit->resetCounter();
+
+    // Polling faster than the sensor, each sample is read once and never skipped
+    constexpr uint32_t COUNT{64};
+    uint32_t updated{};
+    auto timeout_at = m5::utility::millis() + unit->interval() * (COUNT + 4);
+    do {
+        m5::utility::delay(1);
+        unit->update();
+        updated += unit->updated();
+    } while (updated < COUNT && m5::utility::millis() <= timeout_at);
+    EXPECT_EQ(updated, COUNT);
+
+    auto& c = unit->counter();
+    EXPECT_EQ(c.read, COUNT);
+    EXPECT_EQ(c.skipped, 0U);
+    EXPECT_EQ(c.error, 0U);
+    EXPECT_EQ(c.bus_error, 0U);
+    // At most one early probe per 16 reads, and the phase settles
+    EXPECT_LE(c.probe_miss, COUNT / 16);
+    EXPECT_LE(c.not_ready, COUNT / 8);
+    // M5_LOGI("read:%u probe_miss:%u not_ready:%u", c.read, c.probe_miss, c.not_ready);
+
+    // Late polling skips the samples overwritten on the sensor
+    unit->resetCounter();
+    m5::utility::delay(unit->interval() * 3 + unit->interval() / 2);
+    unit->update();
+    EXPECT_TRUE(unit->updated());
+    EXPECT_EQ(c.read, 1U);
+    EXPECT_GE(c.skipped, 2U);
+    EXPECT_LE(c.skipped, 3U);
+
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(unit->inPeriodic());
+}
+
 namespace {
 void printStatus(const Status& s)
 {
@@ -402,3 +445,79 @@ TEST_F(TestSHT30, SerialNumber)
         EXPECT_STREQ(s.c_str(), ssno);
     }
 }
+
+TEST_F(TestSHT30, Alert)
+{
+    SCOPED_TRACE(ustr);
+
+    // Encoding keeps 7 bits of humidity and 9 bits of temperature
+    {
+        float t{}, rh{};
+        raw_to_alert_limit(alert_limit_to_raw(60.0f, 80.0f), t, rh);
+        EXPECT_NEAR(t, 60.0f, 0.35f);
+        EXPECT_NEAR(rh, 80.0f, 0.8f);
+        raw_to_alert_limit(alert_limit_to_raw(-100.0f, 200.0f), t, rh);  // Clamped
+        EXPECT_NEAR(t, -45.0f, 0.35f);
+        EXPECT_NEAR(rh, 100.0f, 0.8f);
+    }
+
+    constexpr std::tuple<Alert, float, float> table[] = {
+        {Alert::HighSet, 40.0f, 70.0f},
+        {Alert::HighClear, 38.0f, 65.0f},
+        {Alert::LowClear, 2.0f, 25.0f},
+        {Alert::LowSet, 0.0f, 20.0f},
+    };
+    for (auto&& e : table) {
+        Alert a{};
+        float t{}, rh{}, rt{}, rrh{};
+        std::tie(a, t, rh) = e;
+        EXPECT_TRUE(unit->writeAlertLimit(a, t, rh));
+        EXPECT_TRUE(unit->readAlertLimit(a, rt, rrh));
+        EXPECT_NEAR(rt, t, 0.35f);
+        EXPECT_NEAR(rrh, rh, 0.8f);
+    }
+
+    // Set the alert by the low limits higher than the environment
+    EXPECT_TRUE(unit->writeAlertLimit(Alert::LowSet, 100.0f, 98.0f));
+    EXPECT_TRUE(unit->writeAlertLimit(Alert::LowClear, 110.0f, 99.0f));
+
+    // The pending bit from the reset is cleared
+    EXPECT_TRUE(unit->watchAlert(true));
+    EXPECT_TRUE(unit->watchingAlert());
+    Status s{};
+    EXPECT_TRUE(unit->readStatus(s));
+    EXPECT_FALSE(s.alertPending());
+    auto timeout_at = m5::utility::millis() + unit->interval() * 4;
+    do {
+        unit->update();
+        m5::utility::delay(1);
+    } while (!unit->updated() && m5::utility::millis() <= timeout_at);
+    EXPECT_TRUE(unit->updated());
+    check_measurement_values(unit.get());
+
+    // No alert, no data
+    EXPECT_TRUE(unit->writeAlertLimit(Alert::LowSet, -40.0f, 0.0f));
+    EXPECT_TRUE(unit->writeAlertLimit(Alert::LowClear, -38.0f, 2.0f));
+    EXPECT_TRUE(unit->writeAlertLimit(Alert::HighSet, 125.0f, 100.0f));
+    EXPECT_TRUE(unit->writeAlertLimit(Alert::HighClear, 120.0f, 99.0f));
+    // The pending bit is cleared after each fetch, only the alerts still pending are fetched
+    timeout_at = m5::utility::millis() + unit->interval() * 4;
+    uint32_t updated{};
+    do {
+        unit->update();
+        updated += unit->updated();
+        m5::utility::delay(1);
+    } while (m5::utility::millis() <= timeout_at);
+    EXPECT_LE(updated, 1U);  // The measurement before the new limits
+    updated    = 0;
+    timeout_at = m5::utility::millis() + unit->interval() * 4;
+    do {
+        unit->update();
+        updated += unit->updated();
+        m5::utility::delay(1);
+    } while (m5::utility::millis() <= timeout_at);
+    EXPECT_EQ(updated, 0U);
+
+    EXPECT_TRUE(unit->watchAlert(false));
+    EXPECT_FALSE(unit->watchingAlert());
+}
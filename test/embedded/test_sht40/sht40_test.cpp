@@ -17,6 +17,7 @@
 #include <chrono>
 #include <cmath>
 #include <random>
+#include <vector>
 
 using namespace m5::unit::googletest;
 using namespace m5::unit;
@@ -244,3 +245,90 @@ TEST_F(TestSHT40, Periodic)
         EXPECT_FALSE(unit->inPeriodic());
     }
 }
+
+TEST_F(TestSHT40, HeaterPolicy)
+{
+    SCOPED_TRACE(ustr);
+
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(unit->inPeriodic());
+
+    auto collect = [this](const uint32_t ms) {
+        std::vector<Data> v{};
+        auto timeout_at = m5::utility::millis() + ms;
+        do {
+            unit->update();
+            if (unit->updated()) {
+                v.push_back(unit->latest());
+            }
+            m5::utility::delay(1);
+        } while (m5::utility::millis() <= timeout_at);
+        return v;
+    };
+
+    HeaterPolicy policy{};
+
+    // Never triggered
+    policy.trigger  = HeaterTrigger::Humidity;
+    policy.humidity = 101.0f;
+    unit->heaterPolicy(policy);
+    EXPECT_TRUE(unit->startPeriodicMeasurement(Precision::High, Heater::Short));
+    // Not applied to the running measurement
+    HeaterPolicy always{policy};
+    always.humidity = -10.0f;
+    unit->heaterPolicy(always);
+    auto v = collect(500);
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_FALSE(v.empty());
+    for (auto&& d : v) {
+        EXPECT_FALSE(d.affected());
+    }
+    EXPECT_EQ(unit->heaterStatistics().pulses, 0U);
+    EXPECT_EQ(unit->heaterStatistics().samples, v.size());
+    EXPECT_FLOAT_EQ(unit->heaterStatistics().duty(), 0.0f);
+
+    // Plateau below the humidity threshold is not regarded as stuck
+    policy.trigger         = HeaterTrigger::Plateau;
+    policy.plateau_samples = 4;
+    policy.plateau_band    = 100.0f;
+    unit->heaterPolicy(policy);
+    EXPECT_TRUE(unit->startPeriodicMeasurement(Precision::High, Heater::Short));
+    v = collect(500);
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_GT(v.size(), 4U);
+    EXPECT_EQ(unit->heaterStatistics().pulses, 0U);
+    policy.trigger = HeaterTrigger::Humidity;
+
+    // Always triggered, but limited by the duty
+    policy.humidity = -10.0f;
+    policy.recovery = 500;
+    unit->heaterPolicy(policy);
+    EXPECT_TRUE(unit->startPeriodicMeasurement(Precision::High, Heater::Short, 0.05f));
+    v = collect(5000);
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+
+    auto& stat = unit->heaterStatistics();
+    EXPECT_EQ(stat.samples, v.size());
+    EXPECT_GE(stat.pulses, 2U);
+    EXPECT_LE(stat.pulses, 3U);
+    // The first pulse is at the start, so slightly higher than the duty in a short run
+    EXPECT_LE(stat.duty(), 0.05f * stat.pulses / (stat.pulses - 1));
+    EXPECT_GT(stat.lost, 0U);
+    EXPECT_GT(stat.lostRatio(), 0.0f);
+
+    uint32_t heater{}, recovery{};
+    bool after_heater{};
+    for (auto&& d : v) {
+        heater += d.heater;
+        recovery += d.recovery;
+        if (after_heater) {
+            EXPECT_TRUE(d.recovery);
+        }
+        after_heater = d.heater;
+    }
+    EXPECT_EQ(heater, stat.heater);
+    EXPECT_EQ(recovery, stat.recovery);
+    EXPECT_GT(recovery, 0U);
+
+    unit->heaterPolicy(HeaterPolicy{});
+}
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest and benchmark for absolute humidity conversion
+*/
+#include <gtest/gtest.h>
+#include <unit/absolute_humidity.hpp>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <limits>
+
+using namespace m5::unit::sgp30;
+
+namespace {
+template <typename F>
+double bench(F func, const std::vector<float>& temps, const std::vector<float>& hums, float& sink)
+{
+    constexpr uint32_t LOOP{200};
+    float acc{};
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < LOOP; ++n) {
+        for (size_t i = 0; i < temps.size(); ++i) {
+            acc += func(temps[i], hums[i]);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    sink += acc;
+    return std::chrono::duration<double, std::nano>(end - start).count() / (LOOP * temps.size());
+}
+
+// Like sht30::Data, no heater
+struct PlainData {
+    float celsius{};
+};
+// Like sht40::Data
+struct HeaterData {
+    bool heater{}, recovery{};
+    bool affected() const
+    {
+        return heater || recovery;
+    }
+};
+}  // namespace
+
+TEST(AbsoluteHumidity, Accuracy)
+{
+    float max_err{};
+    for (float t = ABSOLUTE_HUMIDITY_TEMPERATURE_MIN; t <= ABSOLUTE_HUMIDITY_TEMPERATURE_MAX; t += 0.01f) {
+        for (float rh = 1.0f; rh <= 100.0f; rh += 9.0f) {
+            float exact = absolute_humidity_magnus(t, rh);
+            float fast  = absolute_humidity(t, rh);
+            float err   = std::fabs(fast / exact - 1.0f);
+            max_err     = std::fmax(max_err, err);
+            EXPECT_LE(err, ABSOLUTE_HUMIDITY_MAX_RELATIVE_ERROR) << t << "," << rh;
+        }
+    }
+    std::printf("Max relative error:%f%%\n", max_err * 100.0f);
+
+    // Clamped
+    EXPECT_FLOAT_EQ(absolute_humidity(-50.0f, 50.0f), absolute_humidity(ABSOLUTE_HUMIDITY_TEMPERATURE_MIN, 50.0f));
+    EXPECT_FLOAT_EQ(absolute_humidity(100.0f, 50.0f), absolute_humidity(ABSOLUTE_HUMIDITY_TEMPERATURE_MAX, 50.0f));
+    EXPECT_FLOAT_EQ(absolute_humidity(25.0f, 0.0f), 0.0f);
+}
+
+TEST(AbsoluteHumidity, Raw)
+{
+    EXPECT_EQ(absolute_humidity_to_raw(0.0f), 1U);  // Zero disables compensation
+    EXPECT_EQ(absolute_humidity_to_raw(-1.0f), 1U);
+    EXPECT_EQ(absolute_humidity_to_raw(1.0f), 0x0100U);
+    EXPECT_EQ(absolute_humidity_to_raw(11.757f), 0x0BC2U);  // Example in the datasheet
+    EXPECT_EQ(absolute_humidity_to_raw(255.999f), 0xFFFFU);
+    EXPECT_EQ(absolute_humidity_to_raw(1000.0f), 0xFFFFU);
+}
+
+TEST(AbsoluteHumidity, NotFinite)
+{
+    constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    EXPECT_TRUE(std::isnan(absolute_humidity(nan, 50.0f)));
+    EXPECT_TRUE(std::isnan(absolute_humidity(inf, 50.0f)));
+    EXPECT_TRUE(std::isnan(absolute_humidity(-inf, 50.0f)));
+    EXPECT_TRUE(std::isnan(absolute_humidity(25.0f, nan)));
+    EXPECT_EQ(absolute_humidity_to_raw(nan), 1U);
+}
+
+TEST(AbsoluteHumidity, Compensable)
+{
+    EXPECT_TRUE(compensable(PlainData{}));
+
+    HeaterData d{};
+    EXPECT_TRUE(compensable(d));
+    d.heater = true;
+    EXPECT_FALSE(compensable(d));
+    d.heater   = false;
+    d.recovery = true;
+    EXPECT_FALSE(compensable(d));
+}
+
+TEST(AbsoluteHumidity, Benchmark)
+{
+    std::vector<float> temps, hums;
+    uint32_t seed{12345};
+    for (int i = 0; i < 4096; ++i) {
+        seed = seed * 1103515245U + 12345U;
+        temps.push_back(-40.0f + 125.0f * ((seed >> 8) & 0xFFFF) / 65535.0f);
+        seed = seed * 1103515245U + 12345U;
+        hums.push_back(100.0f * ((seed >> 8) & 0xFFFF) / 65535.0f);
+    }
+
+    float sink{};
+    double magnus = bench(absolute_humidity_magnus, temps, hums, sink);
+    double fast   = bench(absolute_humidity, temps, hums, sink);
+    std::printf("Magnus:%.2f ns/call Fast:%.2f ns/call (x%.2f) %f\n", magnus, fast, magnus / fast, sink);
+    EXPECT_GT(sink, 0.0f);
+}
@@ -0,0 +1,154 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest and benchmark for barometric altitude
+*/
+#include <gtest/gtest.h>
+#include <unit/barometric_altitude.hpp>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <limits>
+
+using namespace m5::unit::barometric;
+
+namespace {
+struct Data {
+    float pa{};
+    float pressure() const
+    {
+        return pa;
+    }
+};
+
+template <typename F>
+double bench(F func, const std::vector<float>& pressures, float& sink)
+{
+    constexpr uint32_t LOOP{200};
+    float acc{};
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < LOOP; ++n) {
+        for (auto&& p : pressures) {
+            acc += func(p);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    sink += acc;
+    return std::chrono::duration<double, std::nano>(end - start).count() / (LOOP * pressures.size());
+}
+}  // namespace
+
+TEST(BarometricAltitude, Accuracy)
+{
+    float max_err{};
+    for (float sea = 95000.0f; sea <= 105000.0f; sea += 2500.0f) {
+        for (float p = PRESSURE_MIN; p <= PRESSURE_MAX; p += 1.0f) {
+            float exact = altitude_pow(p, sea);
+            float fast  = altitude(p, sea);
+            float err   = std::fabs(fast - exact);
+            max_err     = std::fmax(max_err, err);
+            EXPECT_LE(err, ALTITUDE_MAX_ERROR) << p << "," << sea;
+        }
+    }
+    std::printf("Altitude max error:%f m\n", max_err);
+
+    EXPECT_NEAR(altitude(STANDARD_SEA_LEVEL_PRESSURE), 0.0f, 1e-3f);
+    // Clamped
+    EXPECT_FLOAT_EQ(altitude(10000.0f), altitude(PRESSURE_MIN));
+    EXPECT_FLOAT_EQ(altitude(120000.0f), altitude(PRESSURE_MAX));
+}
+
+TEST(BarometricAltitude, SeaLevelPressure)
+{
+    float max_err{};
+    for (float h = ALTITUDE_MIN; h <= ALTITUDE_MAX; h += 0.5f) {
+        float exact = sea_level_pressure_pow(90000.0f, h);
+        float fast  = sea_level_pressure(90000.0f, h);
+        float err   = std::fabs(fast / exact - 1.0f);
+        max_err     = std::fmax(max_err, err);
+        EXPECT_LE(err, SEA_LEVEL_PRESSURE_MAX_RELATIVE_ERROR) << h;
+    }
+    std::printf("Sea level pressure max relative error:%f%%\n", max_err * 100.0f);
+
+    // Round trip (QNH within PRESSURE_MAX)
+    for (float h = 0.0f; h <= 1500.0f; h += 10.0f) {
+        float qnh = sea_level_pressure(90000.0f, h);
+        EXPECT_NEAR(altitude(90000.0f, qnh), h, ALTITUDE_MAX_ERROR * 2) << h;
+    }
+}
+
+TEST(BarometricAltitude, Batch)
+{
+    std::vector<float> pressures;
+    std::vector<Data> data;
+    for (float p = PRESSURE_MIN; p <= PRESSURE_MAX; p += 123.4f) {
+        pressures.push_back(p);
+        data.push_back(Data{p});
+    }
+    const float sea = 100800.0f;
+
+    std::vector<float> out(pressures.size()), out2(pressures.size());
+    altitudes(out.data(), pressures.data(), pressures.size(), sea);
+    auto it = transform_altitude(data.begin(), data.end(), out2.begin(), sea);
+    EXPECT_TRUE(it == out2.end());
+
+    for (size_t i = 0; i < pressures.size(); ++i) {
+        // Multiplication by the reciprocal instead of division
+        EXPECT_NEAR(out[i], altitude(pressures[i], sea), 0.01f) << i;
+        EXPECT_FLOAT_EQ(out[i], out2[i]) << i;
+    }
+}
+
+TEST(BarometricAltitude, NotFinite)
+{
+    // pressure() is NaN if the pressure is skipped or no trimming
+    constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    EXPECT_TRUE(std::isnan(altitude(nan)));
+    EXPECT_TRUE(std::isnan(altitude(inf)));
+    EXPECT_TRUE(std::isnan(altitude(-inf)));
+    EXPECT_TRUE(std::isnan(altitude(90000.0f, nan)));
+    EXPECT_TRUE(std::isnan(sea_level_pressure(90000.0f, nan)));
+    EXPECT_TRUE(std::isnan(sea_level_pressure(90000.0f, inf)));
+    EXPECT_TRUE(std::isnan(sea_level_pressure(nan, 100.0f)));
+
+    const float pa[] = {90000.0f, nan, 100000.0f};
+    float out[3]{};
+    altitudes(out, pa, 3);
+    EXPECT_TRUE(std::isfinite(out[0]));
+    EXPECT_TRUE(std::isnan(out[1]));
+    EXPECT_TRUE(std::isfinite(out[2]));
+}
+
+TEST(BarometricAltitude, Benchmark)
+{
+    std::vector<float> pressures;
+    uint32_t seed{12345};
+    for (int i = 0; i < 4096; ++i) {
+        seed = seed * 1103515245U + 12345U;
+        pressures.push_back(PRESSURE_MIN + (PRESSURE_MAX - PRESSURE_MIN) * ((seed >> 8) & 0xFFFF) / 65535.0f);
+    }
+
+    float sink{};
+    double fpow = bench([](const float p) { return altitude_pow(p); }, pressures, sink);
+    double dpow = bench([](const float p) { return (float)(44330.77 * (1.0 - std::pow(p / 101325.0, 0.190263))); },
+                        pressures, sink);
+    double fast = bench([](const float p) { return altitude(p); }, pressures, sink);
+
+    std::vector<float> out(pressures.size());
+    constexpr uint32_t LOOP{200};
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < LOOP; ++n) {
+        altitudes(out.data(), pressures.data(), pressures.size());
+        sink += out[n % out.size()];
+    }
+    auto end     = std::chrono::steady_clock::now();
+    double batch = std::chrono::duration<double, std::nano>(end - start).count() / (LOOP * pressures.size());
+
+    std::printf("pow(double):%.2f ns/call pow(float):%.2f ns/call Fast:%.2f ns/call (x%.2f) Batch:%.2f ns/sample %f\n",
+                dpow, fpow, fast, fpow / fast, batch, sink);
+    EXPECT_NE(sink, 0.0f);
+}
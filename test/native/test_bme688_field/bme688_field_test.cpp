@@ -0,0 +1,171 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for BME688 burst decoder against bme68x_get_data
+*/
+#include <gtest/gtest.h>
+#include <bme68x/bme68x.h>
+#include <unit/bme688_field_decoder.hpp>
+#include <cstring>
+#include <random>
+
+using namespace m5::unit::bme688;
+
+namespace {
+
+// Register map served to bme68x_get_data
+uint8_t registers[256]{};
+
+BME68X_INTF_RET_TYPE read_function(uint8_t reg, uint8_t* buf, uint32_t len, void*)
+{
+    if (reg + len > sizeof(registers)) {
+        return BME68X_E_COM_FAIL;
+    }
+    std::memcpy(buf, registers + reg, len);
+    return BME68X_OK;
+}
+
+BME68X_INTF_RET_TYPE write_function(uint8_t, const uint8_t*, uint32_t, void*)
+{
+    return BME68X_OK;
+}
+
+void delay_us_function(uint32_t, void*)
+{
+}
+
+template <typename T, class RNG>
+T rand_value(RNG& rng)
+{
+    return static_cast<T>(rng());
+}
+
+void randomize_calibration(bme68x_calib_data& c, std::mt19937& rng)
+{
+    // Around the typical values so that the results are meaningful
+    c.par_t1         = 26000 + rng() % 1000;
+    c.par_t2         = 26000 + rng() % 1000;
+    c.par_t3         = 3;
+    c.par_p1         = 36000 + rng() % 1000;
+    c.par_p2         = -10000 - (int16_t)(rng() % 1000);
+    c.par_p3         = 88;
+    c.par_p4         = 7000 + rng() % 500;
+    c.par_p5         = -100 - (int16_t)(rng() % 50);
+    c.par_p6         = 30;
+    c.par_p7         = 30;
+    c.par_p8         = -1000 - (int16_t)(rng() % 500);
+    c.par_p9         = -3000 - (int16_t)(rng() % 500);
+    c.par_p10        = 30;
+    c.par_h1         = 700 + rng() % 200;
+    c.par_h2         = 1000 + rng() % 100;
+    c.par_h3         = 0;
+    c.par_h4         = 45;
+    c.par_h5         = 20;
+    c.par_h6         = 120;
+    c.par_h7         = -100;
+    c.par_gh1        = -30;
+    c.par_gh2        = -5000;
+    c.par_gh3        = 18;
+    c.res_heat_range = rng() % 4;
+    c.res_heat_val   = rand_value<int8_t>(rng);
+    c.range_sw_err   = (int8_t)(rng() % 16) - 8;
+    c.t_fine         = 0.0f;
+}
+
+void randomize_window(std::mt19937& rng, const bool all_new)
+{
+    for (uint32_t r = burst::START; r < burst::START + burst::LENGTH; ++r) {
+        registers[r] = rand_value<uint8_t>(rng);
+    }
+    if (all_new) {
+        for (uint32_t i = 0; i < burst::FIELDS; ++i) {
+            registers[burst::START + i * burst::FIELD_LENGTH] |= BME68X_NEW_DATA_MSK;
+        }
+    }
+    // Gas index must be within 0 - 9
+    for (uint32_t i = 0; i < burst::FIELDS; ++i) {
+        auto& s = registers[burst::START + i * burst::FIELD_LENGTH];
+        s       = (s & ~BME68X_GAS_INDEX_MSK) | ((s & BME68X_GAS_INDEX_MSK) % 10);
+    }
+}
+
+void expect_same(const bme68x_data& a, const bme68x_data& b)
+{
+    EXPECT_EQ(a.status, b.status);
+    EXPECT_EQ(a.gas_index, b.gas_index);
+    EXPECT_EQ(a.meas_index, b.meas_index);
+    EXPECT_EQ(a.res_heat, b.res_heat);
+    EXPECT_EQ(a.idac, b.idac);
+    EXPECT_EQ(a.gas_wait, b.gas_wait);
+    // Must be bit identical
+    EXPECT_EQ(0, std::memcmp(&a.temperature, &b.temperature, sizeof(float)));
+    EXPECT_EQ(0, std::memcmp(&a.pressure, &b.pressure, sizeof(float)));
+    EXPECT_EQ(0, std::memcmp(&a.humidity, &b.humidity, sizeof(float)));
+    EXPECT_EQ(0, std::memcmp(&a.gas_resistance, &b.gas_resistance, sizeof(float)));
+}
+
+void compare(const uint8_t op_mode, const uint32_t variant, const bool all_new, const uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    bme68x_dev dev{};
+    dev.intf     = BME68X_I2C_INTF;
+    dev.read     = read_function;
+    dev.write    = write_function;
+    dev.delay_us = delay_us_function;
+    dev.amb_temp = 25;
+
+    for (uint32_t n = 0; n < 1000; ++n) {
+        SCOPED_TRACE(n);
+        randomize_calibration(dev.calib, rng);
+        dev.variant_id = variant;
+        randomize_window(rng, all_new);
+
+        bme68x_data expected[3]{};
+        uint8_t num{};
+        int8_t ret = bme68x_get_data(op_mode, expected, &num, &dev);
+
+        bme68x_calib_data calib = dev.calib;
+        bme68x_data actual[3]{};
+        EXPECT_EQ(num, burst::decode(actual, registers + burst::START, op_mode, calib, variant));
+        EXPECT_EQ(ret == BME68X_OK, num != 0);
+
+        // Bosch computes the values of forced mode only if new data
+        const uint32_t cnt = (op_mode == BME68X_FORCED_MODE) ? num : 3;
+        for (uint32_t i = 0; i < cnt; ++i) {
+            SCOPED_TRACE(i);
+            expect_same(expected[i], actual[i]);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(BME688Field, Parallel)
+{
+    compare(BME68X_PARALLEL_MODE, BME68X_VARIANT_GAS_HIGH, true, 1);
+    compare(BME68X_PARALLEL_MODE, BME68X_VARIANT_GAS_HIGH, false, 2);
+    compare(BME68X_PARALLEL_MODE, BME68X_VARIANT_GAS_LOW, false, 3);
+}
+
+TEST(BME688Field, Sequential)
+{
+    compare(BME68X_SEQUENTIAL_MODE, BME68X_VARIANT_GAS_HIGH, false, 4);
+}
+
+TEST(BME688Field, Forced)
+{
+    compare(BME68X_FORCED_MODE, BME68X_VARIANT_GAS_HIGH, true, 5);
+    compare(BME68X_FORCED_MODE, BME68X_VARIANT_GAS_LOW, true, 6);
+    compare(BME68X_FORCED_MODE, BME68X_VARIANT_GAS_HIGH, false, 7);
+}
+
+TEST(BME688Field, Window)
+{
+    // 0x1D - 0x4F fields and 0x50 - 0x6D heater settings
+    EXPECT_EQ(burst::START + burst::FIELDS * burst::FIELD_LENGTH, 0x50);
+    EXPECT_EQ(burst::START + burst::SETTINGS_OFFSET, 0x50);
+    EXPECT_EQ(burst::START + burst::LENGTH - 1, 0x6D);
+}
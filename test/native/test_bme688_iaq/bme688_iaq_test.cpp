@@ -0,0 +1,234 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest and validation for open IAQ estimator of BME688
+*/
+#include <gtest/gtest.h>
+#include <unit/bme688_iaq_estimator.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace m5::unit::bme688;
+
+namespace {
+struct Sample {
+    float gas{};       // Ohm
+    float humidity{};  // %RH
+};
+
+IAQEstimator::config_t small_config()
+{
+    IAQEstimator::config_t cfg{};
+    cfg.burn_in  = 10;
+    cfg.learning = 100;
+    return cfg;
+}
+
+float feed(IAQEstimator& e, const float gas, const float rh, const uint32_t n)
+{
+    float v{};
+    for (uint32_t i = 0; i < n; ++i) {
+        v = e.update(gas, rh);
+    }
+    return v;
+}
+}  // namespace
+
+TEST(BME688IAQ, Accuracy)
+{
+    IAQEstimator e(small_config());
+    EXPECT_EQ(e.accuracy(), 0);
+    EXPECT_TRUE(std::isnan(feed(e, 100e3f, 40.0f, 10)));
+    EXPECT_EQ(e.accuracy(), 0);
+    feed(e, 100e3f, 40.0f, 1);
+    EXPECT_EQ(e.accuracy(), 1);
+    feed(e, 100e3f, 40.0f, 49);
+    EXPECT_EQ(e.accuracy(), 2);
+    feed(e, 100e3f, 40.0f, 50);
+    EXPECT_EQ(e.accuracy(), 3);
+    EXPECT_TRUE(e.learned());
+
+    // Invalid values are ignored
+    auto n = e.samples();
+    e.update(0.0f, 40.0f);
+    e.update(NAN, 40.0f);
+    e.update(100e3f, NAN);
+    EXPECT_EQ(e.samples(), n);
+
+    e.reset();
+    EXPECT_EQ(e.accuracy(), 0);
+    EXPECT_TRUE(std::isnan(e.iaq()));
+}
+
+TEST(BME688IAQ, Response)
+{
+    IAQEstimator e(small_config());
+    // Clean air at the ideal humidity
+    float clean = feed(e, 100e3f, 40.0f, 200);
+    EXPECT_LE(clean, 10.0f);
+    // VOC event (resistance drops)
+    float v1 = feed(e, 50e3f, 40.0f, 5);
+    float v2 = feed(e, 20e3f, 40.0f, 5);
+    EXPECT_GT(v1, clean);
+    EXPECT_GT(v2, v1);
+    EXPECT_GE(v2, 300.0f);
+    EXPECT_LE(v2, 500.0f);
+    // Recovery
+    float back = feed(e, 100e3f, 40.0f, 5);
+    EXPECT_NEAR(back, clean, 10.0f);
+    // Cleaner air raises the baseline quickly
+    feed(e, 150e3f, 40.0f, 200);
+    EXPECT_NEAR(e.baseline(), std::log(150e3f) + e.config().humidity_slope * 40.0f, 0.01f);
+}
+
+TEST(BME688IAQ, HumidityCompensation)
+{
+    const auto cfg = small_config();
+    IAQEstimator e(cfg);
+    feed(e, 100e3f, 40.0f, 200);
+    // Resistance falls as humidity rises, the gas score must stay
+    const float rh  = 60.0f;
+    const float ohm = 100e3f * std::exp(-cfg.humidity_slope * (rh - 40.0f));
+    float v         = feed(e, ohm, rh, 5);
+    // Only the humidity score changes: (1 - (100-60)/(100-40)) * weight * 500
+    EXPECT_NEAR(v, (1.0f - 40.0f / 60.0f) * cfg.humidity_weight * 500.0f, 1.0f);
+}
+
+TEST(BME688IAQ, Range)
+{
+    IAQEstimator e(small_config());
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> gas(1e3f, 1e6f), hum(0.0f, 100.0f);
+    for (uint32_t i = 0; i < 100000; ++i) {
+        float v = e.update(gas(rng), hum(rng));
+        if (e.accuracy()) {
+            EXPECT_GE(v, 0.0f);
+            EXPECT_LE(v, 500.0f);
+        }
+    }
+}
+
+TEST(BME688IAQ, Restore)
+{
+    IAQEstimator a(small_config());
+    feed(a, 100e3f, 40.0f, 200);
+
+    IAQEstimator b(small_config());
+    b.baseline(a.baseline());
+    feed(b, 100e3f, 40.0f, 10);
+    EXPECT_EQ(b.accuracy(), 0);  // Burn-in is still required
+    feed(b, 100e3f, 40.0f, 1);
+    EXPECT_EQ(b.accuracy(), 3);
+    EXPECT_NEAR(b.iaq(), a.iaq(), 1.0f);
+}
+
+TEST(BME688IAQ, Benchmark)
+{
+    // Fixed memory
+    EXPECT_LE(sizeof(IAQEstimator), 64U);
+
+    std::vector<Sample> v(10000);
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> gas(10e3f, 200e3f), hum(20.0f, 80.0f);
+    for (auto& s : v) {
+        s.gas      = gas(rng);
+        s.humidity = hum(rng);
+    }
+    IAQEstimator e(small_config());
+    constexpr uint32_t LOOP{100};
+    float sink{};
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < LOOP; ++n) {
+        for (auto& s : v) {
+            float r = e.update(s.gas, s.humidity);
+            sink += std::isnan(r) ? 0.0f : r;
+        }
+    }
+    auto end  = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / (LOOP * v.size());
+    std::printf("IAQEstimator::update: %.2f ns/sample (%f)\n", ns, sink);
+}
+
+namespace {
+/*
+  Pearson correlation of the estimator and the reference IAQ where both are calibrated
+  CSV with lines of "raw_gas(Ohm),raw_humidity(%RH),iaq,iaq_accuracy" (3 seconds cadence)
+*/
+void correlate(const std::string& path, double& r, uint32_t& n)
+{
+    r        = 0.0;
+    n        = 0;
+    FILE* fp = std::fopen(path.c_str(), "r");
+    ASSERT_NE(fp, nullptr) << path;
+
+    IAQEstimator e{};
+    double sx{}, sy{}, sxx{}, syy{}, sxy{}, mae{};
+    float gas{}, hum{}, iaq{};
+    unsigned acc{};
+    char line[128]{};
+    while (std::fgets(line, sizeof(line), fp)) {
+        if (std::sscanf(line, "%f,%f,%f,%u", &gas, &hum, &iaq, &acc) != 4) {
+            continue;  // Header or broken line
+        }
+        float v = e.update(gas, hum);
+        // Compare only where both are calibrated
+        if (acc < 3 || !e.learned()) {
+            continue;
+        }
+        sx += v;
+        sy += iaq;
+        sxx += (double)v * v;
+        syy += (double)iaq * iaq;
+        sxy += (double)v * iaq;
+        mae += std::fabs(v - iaq);
+        ++n;
+    }
+    std::fclose(fp);
+    ASSERT_GT(n, 100U) << "Not enough calibrated samples";
+
+    double cov = sxy - sx * sy / n;
+    r          = cov / std::sqrt((sxx - sx * sx / n) * (syy - sy * sy / n));
+    std::printf("Samples:%u Pearson:%.3f MAE:%.1f\n", n, r, mae / n);
+}
+}  // namespace
+
+/*
+  Sanity check with synthetic_trend.csv next to this file
+  It is synthetic (see its header) and NOT recorded from BSEC2, so it only shows the estimator follows VOC events
+*/
+TEST(BME688IAQ, SyntheticTrend)
+{
+    std::string path{__FILE__};
+    auto pos = path.find_last_of("/\\");
+    path     = (pos != std::string::npos ? path.substr(0, pos + 1) : std::string{}) + "synthetic_trend.csv";
+
+    double r{};
+    uint32_t n{};
+    correlate(path, r, n);
+    EXPECT_GE(r, 0.7);
+}
+
+/*
+  Validation against BSEC2
+  Set M5_BME688_BSEC2_LOG to a CSV recorded from UnitBME688 with BSEC2 (LowPower), skipped otherwise
+*/
+TEST(BME688IAQ, BSEC2)
+{
+    const char* env = std::getenv("M5_BME688_BSEC2_LOG");
+    if (!env) {
+        GTEST_SKIP() << "M5_BME688_BSEC2_LOG is not set";
+    }
+    double r{};
+    uint32_t n{};
+    correlate(env, r, n);
+    // Trend must follow BSEC2, the absolute scale is not compatible
+    EXPECT_GE(r, 0.7);
+}
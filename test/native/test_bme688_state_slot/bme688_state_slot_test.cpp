@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for the slot codec of the BSEC2 state
+*/
+#include <gtest/gtest.h>
+#include <unit/bme688_state_slot.hpp>
+#include <unit/blob_storage.hpp>
+#include <vector>
+
+using namespace m5::unit::bme688::state_slot;
+
+namespace {
+constexpr size_t CAPACITY{221};  // Same as BSEC_MAX_STATE_BLOB_SIZE
+
+std::vector<uint8_t> make_slot(const uint32_t seq, const uint8_t accuracy, const uint32_t len = 139)
+{
+    std::vector<uint8_t> buf(HEADER_SIZE + CAPACITY);
+    for (uint32_t i = 0; i < len; ++i) {
+        buf[HEADER_SIZE + i] = (uint8_t)(i * 7 + seq);
+    }
+    Header h{};
+    h.accuracy = accuracy;
+    h.sequence = seq;
+    h.length   = len;
+    EXPECT_TRUE(encode(buf.data(), CAPACITY, h));
+    return buf;
+}
+}  // namespace
+
+TEST(StateSlot, CRC32)
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(~crc32(check, sizeof(check)), 0xCBF43926U);
+    // Chained
+    EXPECT_EQ(~crc32(check + 4, 5, crc32(check, 4)), 0xCBF43926U);
+}
+
+TEST(StateSlot, Codec)
+{
+    auto buf = make_slot(0x12345678U, 3);
+    EXPECT_EQ(buf[0], MAGIC0);
+    EXPECT_EQ(buf[1], MAGIC1);
+    EXPECT_EQ(buf[2], VERSION);
+    EXPECT_EQ(buf[3], 3);
+    EXPECT_EQ(buf[4], 0x78);  // Little endian
+    EXPECT_EQ(buf[7], 0x12);
+
+    Header h{};
+    EXPECT_TRUE(decode(buf.data(), CAPACITY, h));
+    EXPECT_EQ(h.accuracy, 3);
+    EXPECT_EQ(h.sequence, 0x12345678U);
+    EXPECT_EQ(h.length, 139U);
+
+    // Too long state
+    Header over{};
+    over.length = CAPACITY + 1;
+    EXPECT_FALSE(encode(buf.data(), CAPACITY, over));
+    EXPECT_TRUE(decode(buf.data(), CAPACITY, h));  // Untouched
+}
+
+TEST(StateSlot, Corrupted)
+{
+    const auto good = make_slot(42, 2);
+    Header h{};
+
+    // Any single bit flip in the header and the whole state area (also beyond the length)
+    for (size_t i = 0; i < good.size(); ++i) {
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            auto buf = good;
+            buf[i] ^= (1U << bit);
+            SCOPED_TRACE(i);
+            EXPECT_FALSE(decode(buf.data(), CAPACITY, h));
+        }
+    }
+
+    // Length over the capacity with the valid CRC
+    auto buf = good;
+    buf[8]   = CAPACITY + 1;
+    uint32_t crc{~crc32(buf.data() + HEADER_SIZE, CAPACITY, crc32(buf.data(), 12))};
+    for (uint8_t i = 0; i < 4; ++i) {
+        buf[12 + i] = crc >> (i * 8);
+    }
+    EXPECT_FALSE(decode(buf.data(), CAPACITY, h));
+
+    // Different capacity
+    EXPECT_FALSE(decode(good.data(), CAPACITY - 1, h));
+
+    // Erased storage
+    std::vector<uint8_t> erased(good.size(), 0xFF);
+    EXPECT_FALSE(decode(erased.data(), CAPACITY, h));
+    std::vector<uint8_t> zero(good.size(), 0x00);
+    EXPECT_FALSE(decode(zero.data(), CAPACITY, h));
+}
+
+TEST(StateSlot, Sequence)
+{
+    EXPECT_TRUE(newer(2, 1));
+    EXPECT_FALSE(newer(1, 2));
+    EXPECT_FALSE(newer(1, 1));
+    EXPECT_TRUE(newer(0, 0xFFFFFFFFU));  // Wrap around
+    EXPECT_TRUE(newer(3, 0xFFFFFFFEU));
+    EXPECT_FALSE(newer(0xFFFFFFFFU, 0));
+
+    EXPECT_EQ(select(false, 0, false, 0), -1);
+    EXPECT_EQ(select(true, 5, false, 9), 0);
+    EXPECT_EQ(select(false, 9, true, 5), 1);
+    EXPECT_EQ(select(true, 5, true, 6), 1);
+    EXPECT_EQ(select(true, 6, true, 5), 0);
+    EXPECT_EQ(select(true, 0, true, 0xFFFFFFFFU), 0);  // Wrap around
+    EXPECT_EQ(select(true, 0xFFFFFFFFU, true, 0), 1);
+}
+
+TEST(StateSlot, Alternate)
+{
+    // Two slots written alternately as StateManager does, the newest valid one survives a broken write
+    m5::unit::MemoryBlobStorage<HEADER_SIZE + CAPACITY> storage[2];
+    uint32_t seq{0xFFFFFFFDU};  // Wraps around in the loop
+    uint8_t last{1};
+
+    auto load = [&storage](std::vector<uint8_t>& out) {
+        std::vector<uint8_t> buf[2]{std::vector<uint8_t>(HEADER_SIZE + CAPACITY),
+                                    std::vector<uint8_t>(HEADER_SIZE + CAPACITY)};
+        Header h[2]{};
+        bool valid[2]{};
+        for (int i = 0; i < 2; ++i) {
+            valid[i] = storage[i].read(nullptr, buf[i].data(), buf[i].size()) && decode(buf[i].data(), CAPACITY, h[i]);
+        }
+        int s = select(valid[0], h[0].sequence, valid[1], h[1].sequence);
+        if (s >= 0) {
+            out = buf[s];
+        }
+        return s;
+    };
+
+    std::vector<uint8_t> loaded;
+    EXPECT_EQ(load(loaded), -1);  // Empty
+
+    for (int i = 0; i < 6; ++i) {
+        auto buf = make_slot(++seq, i & 3);
+        last ^= 1;
+        ASSERT_TRUE(storage[last].write(nullptr, buf.data(), buf.size()));
+        EXPECT_EQ(load(loaded), last);
+        EXPECT_EQ(loaded, buf);
+    }
+
+    // Power cut while writing the next slot
+    auto good = make_slot(seq, 5 & 3);
+    auto torn = make_slot(seq + 1, 2);
+    std::fill(torn.begin() + HEADER_SIZE + CAPACITY / 2, torn.end(), 0xFF);
+    ASSERT_TRUE(storage[last ^ 1].write(nullptr, torn.data(), torn.size()));
+    EXPECT_EQ(load(loaded), last);
+    EXPECT_EQ(loaded, good);
+}
@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for deadband
+*/
+#include <gtest/gtest.h>
+#include <unit/deadband.hpp>
+#include <limits>
+#include <cstdio>
+
+using namespace m5::unit::deadband;
+
+namespace {
+enum class Field : uint8_t { Temperature, Pressure };
+using DB = Deadband<Field, 2>;
+}  // namespace
+
+TEST(Deadband, Threshold)
+{
+    DB db;
+    DB::config_t cfg{};
+    cfg[Field::Temperature] = 0.1f;
+    cfg[Field::Pressure]    = 5.0f;
+    db.config(cfg);
+    EXPECT_FLOAT_EQ(db.config()[Field::Pressure], 5.0f);
+
+    EXPECT_TRUE(db.check({{25.0f, 100000.0f}}, 0));  // First
+    EXPECT_FALSE(db.check({{25.05f, 100004.0f}}, 1000));
+    EXPECT_FALSE(db.check({{24.95f, 99996.0f}}, 2000));
+    EXPECT_TRUE(db.check({{25.2f, 100000.0f}}, 3000));
+    // Compared with the last changed sample, slow drift is detected
+    EXPECT_FALSE(db.check({{25.25f, 100003.0f}}, 4000));
+    EXPECT_TRUE(db.check({{25.25f, 100006.0f}}, 5000));
+
+    EXPECT_EQ(db.samples(), 6U);
+    EXPECT_EQ(db.changes(), 3U);
+    EXPECT_EQ(db.heartbeats(), 0U);
+    EXPECT_FLOAT_EQ(db.suppression(), 0.5f);
+
+    db.reset();
+    EXPECT_EQ(db.samples(), 0U);
+    EXPECT_FLOAT_EQ(db.suppression(), 0.0f);
+    EXPECT_TRUE(db.check({{25.25f, 100006.0f}}, 6000));
+}
+
+TEST(Deadband, ZeroAndIgnored)
+{
+    DB db;
+    DB::config_t cfg{};
+    cfg[Field::Pressure] = -1.0f;  // Ignored
+    db.config(cfg);
+
+    EXPECT_TRUE(db.check({{25.0f, 100000.0f}}, 0));
+    EXPECT_FALSE(db.check({{25.0f, 90000.0f}}, 1));
+    EXPECT_TRUE(db.check({{25.01f, 90000.0f}}, 2));  // Any change
+
+    // NaN to/from a value
+    EXPECT_TRUE(db.check({{std::numeric_limits<float>::quiet_NaN(), 0.0f}}, 3));
+    EXPECT_FALSE(db.check({{std::numeric_limits<float>::quiet_NaN(), 0.0f}}, 4));
+    EXPECT_TRUE(db.check({{25.0f, 0.0f}}, 5));
+}
+
+TEST(Deadband, Heartbeat)
+{
+    DB db;
+    DB::config_t cfg{};
+    cfg[Field::Temperature] = 1.0f;
+    cfg[Field::Pressure]    = 100.0f;
+    cfg.heartbeat           = 10000;
+    db.config(cfg);
+
+    uint32_t changed{};
+    // Wrap around of the time
+    const uint32_t base{0xFFFFFFFFU - 25000};
+    for (uint32_t t = 0; t < 60000; t += 1000) {
+        changed += db.check({{25.0f, 100000.0f}}, base + t);
+    }
+    // 0, 10000, 20000, ...
+    EXPECT_EQ(changed, 6U);
+    EXPECT_EQ(db.heartbeats(), 5U);
+    std::printf("Suppression:%f\n", db.suppression());
+    EXPECT_NEAR(db.suppression(), 54.0f / 60.0f, 1e-6f);
+}
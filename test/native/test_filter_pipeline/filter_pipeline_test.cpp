@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest and benchmark for filter pipeline
+*/
+#include <gtest/gtest.h>
+#include <unit/filter_pipeline.hpp>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+
+using namespace m5::unit::filter;
+
+namespace {
+enum class Field : uint8_t { Temperature, Pressure };
+using Pipe = Pipeline<Field, 2>;
+
+// Pressure (Pa) with slow drift and white noise
+struct Signal {
+    std::vector<float> truth, measured;
+};
+
+Signal make_signal(const float sigma, const size_t num = 20000)
+{
+    Signal s;
+    std::mt19937 rng{12345};
+    std::normal_distribution<float> noise(0.0f, sigma), walk(0.0f, 0.05f);
+    float p{101325.0f};
+    for (size_t i = 0; i < num; ++i) {
+        p += walk(rng);
+        s.truth.push_back(p);
+        s.measured.push_back(p + noise(rng));
+    }
+    return s;
+}
+
+float rms_error(Chain& c, const Signal& s, double& ns)
+{
+    constexpr size_t SKIP{100};  // Settling
+    double acc{};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<float> out(s.measured.size());
+    for (size_t i = 0; i < s.measured.size(); ++i) {
+        out[i] = c.apply(s.measured[i]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    ns       = std::chrono::duration<double, std::nano>(end - start).count() / s.measured.size();
+    for (size_t i = SKIP; i < out.size(); ++i) {
+        acc += (out[i] - s.truth[i]) * (out[i] - s.truth[i]);
+    }
+    return std::sqrt(acc / (out.size() - SKIP));
+}
+}  // namespace
+
+TEST(FilterPipeline, Median)
+{
+    Chain c;
+    c.config({{Stage::median(3)}});
+    EXPECT_FLOAT_EQ(c.apply(1.0f), 1.0f);
+    EXPECT_FLOAT_EQ(c.apply(3.0f), 2.0f);  // Average of the middle while filling
+    EXPECT_FLOAT_EQ(c.apply(2.0f), 2.0f);
+    EXPECT_FLOAT_EQ(c.apply(100.0f), 3.0f);  // Spike removed
+    EXPECT_FLOAT_EQ(c.apply(4.0f), 4.0f);
+    EXPECT_FLOAT_EQ(c.apply(5.0f), 5.0f);
+
+    EXPECT_EQ(Stage::median(4).window, 5U);
+    EXPECT_EQ(Stage::median(0).window, 1U);
+    EXPECT_EQ(Stage::median(100).window, MAX_WINDOW);
+}
+
+TEST(FilterPipeline, IIRAndKalman)
+{
+    Chain iir;
+    iir.config({{Stage::iir(0.5f)}});
+    EXPECT_FLOAT_EQ(iir.apply(10.0f), 10.0f);
+    EXPECT_FLOAT_EQ(iir.apply(20.0f), 15.0f);
+    EXPECT_TRUE(std::isnan(iir.apply(std::numeric_limits<float>::quiet_NaN())));  // Pass through
+    EXPECT_FLOAT_EQ(iir.apply(15.0f), 15.0f);
+    iir.reset();
+    EXPECT_FLOAT_EQ(iir.apply(0.0f), 0.0f);
+
+    // Converges to the constant
+    Chain k;
+    k.config({{Stage::kalman(0.001f, 1.0f)}});
+    EXPECT_FLOAT_EQ(k.apply(10.0f), 10.0f);
+    float v{};
+    for (int i = 0; i < 100; ++i) {
+        v = k.apply(i & 1 ? 11.0f : 9.0f);
+    }
+    EXPECT_NEAR(v, 10.0f, 0.2f);
+}
+
+TEST(FilterPipeline, Pipeline)
+{
+    Pipe pipe;
+    pipe.config(Field::Pressure, {{Stage::median(3), Stage::iir(1.0f)}});
+    EXPECT_EQ(pipe.config(Field::Pressure)[0].type, Type::Median);
+    EXPECT_EQ(pipe.config(Field::Temperature)[0].type, Type::None);
+
+    pipe.apply({{25.0f, 1.0f}});
+    pipe.apply({{26.0f, 2.0f}});
+    auto out = pipe.apply({{27.0f, 100.0f}});
+    EXPECT_FLOAT_EQ(out[0], 27.0f);  // Pass through
+    EXPECT_FLOAT_EQ(out[1], 2.0f);
+
+    auto inv = Pipe::invalid();
+    EXPECT_TRUE(std::isnan(inv[0]) && std::isnan(inv[1]));
+}
+
+TEST(FilterPipeline, Benchmark)
+{
+    // BMP280 pressure noise (datasheet typ.): 1.3 Pa at x1, conversion time 2 ms per pressure oversampling
+    constexpr float SIGMA_X1{1.3f};
+    constexpr float MS_PER_OVERSAMPLING{2.0f};
+    auto sig = make_signal(SIGMA_X1);
+
+    struct Case {
+        const char* name;
+        Chain::config_t cfg;
+    };
+    const Case cases[] = {
+        {"None", {}},
+        {"Median5", {{Stage::median(5)}}},
+        {"IIR0.25", {{Stage::iir(0.25f)}}},
+        {"Kalman", {{Stage::kalman(0.0025f, SIGMA_X1 * SIGMA_X1)}}},
+        {"Median3+IIR0.25", {{Stage::median(3), Stage::iir(0.25f)}}},
+        {"Median3+Kalman", {{Stage::median(3), Stage::kalman(0.0025f, SIGMA_X1 * SIGMA_X1)}}},
+    };
+    float none{};
+    for (auto&& c : cases) {
+        Chain chain;
+        chain.config(c.cfg);
+        double ns{};
+        float rms = rms_error(chain, sig, ns);
+        none      = none ? none : rms;
+        std::printf("Software %-16s RMS:%.3f Pa %.2f ns/sample\n", c.name, rms, ns);
+        EXPECT_LE(rms, none * 1.01f) << c.name;
+    }
+    // Hardware oversampling reduces the noise by sqrt(N) and costs the conversion time (and the current) per sample
+    for (uint32_t n = 1; n <= 16; n <<= 1) {
+        std::printf("Hardware x%-2u RMS:%.3f Pa +%.1f ms/sample\n", n, SIGMA_X1 / std::sqrt((float)n),
+                    MS_PER_OVERSAMPLING * (n - 1));
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest and benchmark for online statistics
+*/
+#include <gtest/gtest.h>
+#include <unit/online_statistics.hpp>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+
+using namespace m5::unit::statistics;
+
+namespace {
+enum class Field : uint8_t { Temperature, Pressure };
+using Stats = Statistics<Field, 2>;
+}  // namespace
+
+TEST(OnlineStatistics, Accumulator)
+{
+    Accumulator acc;
+    auto s = acc.snapshot();
+    EXPECT_EQ(s.count, 0U);
+    EXPECT_TRUE(std::isnan(s.mean));
+    EXPECT_TRUE(std::isnan(s.variance));
+
+    acc.push(3.0f);
+    s = acc.snapshot();
+    EXPECT_EQ(s.count, 1U);
+    EXPECT_FLOAT_EQ(s.mean, 3.0f);
+    EXPECT_FLOAT_EQ(s.variance, 0.0f);
+    EXPECT_FLOAT_EQ(s.ewma, 3.0f);
+
+    acc.push(std::numeric_limits<float>::quiet_NaN());  // Ignored
+    acc.push(std::numeric_limits<float>::infinity());
+    EXPECT_EQ(acc.snapshot().count, 1U);
+
+    acc.push(5.0f, 0.5f);
+    s = acc.snapshot();
+    EXPECT_EQ(s.count, 2U);
+    EXPECT_FLOAT_EQ(s.mean, 4.0f);
+    EXPECT_FLOAT_EQ(s.variance, 2.0f);
+    EXPECT_FLOAT_EQ(s.minimum, 3.0f);
+    EXPECT_FLOAT_EQ(s.maximum, 5.0f);
+    EXPECT_FLOAT_EQ(s.ewma, 4.0f);
+
+    acc.reset();
+    EXPECT_EQ(acc.snapshot().count, 0U);
+}
+
+TEST(OnlineStatistics, TwoPass)
+{
+    // Pressure in Pa, large mean and small variance
+    std::vector<float> v;
+    uint32_t seed{12345};
+    for (int i = 0; i < 100000; ++i) {
+        seed = seed * 1103515245U + 12345U;
+        v.push_back(101325.0f + 4.0f * ((seed >> 8) & 0xFFFF) / 65535.0f);
+    }
+    Accumulator acc;
+    double sum{};
+    for (auto&& x : v) {
+        acc.push(x);
+        sum += x;
+    }
+    const double mean = sum / v.size();
+    double m2{};
+    for (auto&& x : v) {
+        m2 += (x - mean) * (x - mean);
+    }
+    const double var = m2 / (v.size() - 1);
+
+    auto s = acc.snapshot();
+    EXPECT_EQ(s.count, v.size());
+    EXPECT_NEAR(s.mean, mean, 0.01);
+    EXPECT_NEAR(s.variance, var, var * 1e-4);
+    EXPECT_FLOAT_EQ(s.minimum, *std::min_element(v.begin(), v.end()));
+    EXPECT_FLOAT_EQ(s.maximum, *std::max_element(v.begin(), v.end()));
+    std::printf("Mean:%f/%f Variance:%f/%f\n", s.mean, mean, s.variance, var);
+}
+
+TEST(OnlineStatistics, Statistics)
+{
+    Stats stats;
+    stats.alpha(2.0f);
+    EXPECT_FLOAT_EQ(stats.alpha(), 1.0f);
+    stats.alpha(0.25f);
+
+    stats.push({{20.0f, 100000.0f}});
+    stats.push({{22.0f, std::numeric_limits<float>::quiet_NaN()}});  // Fields are independent
+    EXPECT_EQ(stats.sequence(), 2U);
+
+    auto t = stats.snapshot(Field::Temperature);
+    auto p = stats.snapshot(Field::Pressure);
+    EXPECT_EQ(t.count, 2U);
+    EXPECT_FLOAT_EQ(t.mean, 21.0f);
+    EXPECT_FLOAT_EQ(t.ewma, 20.5f);
+    EXPECT_EQ(p.count, 1U);
+    EXPECT_FLOAT_EQ(p.mean, 100000.0f);
+
+    stats.reset();
+    EXPECT_EQ(stats.sequence(), 3U);
+    EXPECT_EQ(stats.snapshot(Field::Temperature).count, 0U);
+}
+
+TEST(OnlineStatistics, Concurrent)
+{
+    // Producer pushes the same value to both fields, reader must never see them torn
+    constexpr uint32_t NUM{200000};
+    Stats stats;
+    std::thread producer([&stats] {
+        for (uint32_t i = 0; i < NUM; ++i) {
+            stats.push({{(float)i, (float)i}});
+        }
+    });
+
+    uint32_t reads{}, torn{};
+    Stats::snapshots_t s{};
+    do {
+        s = stats.snapshot();
+        ++reads;
+        torn += (s[0].count != s[1].count);
+        if (s[0].count) {
+            torn += (s[0].maximum != s[1].maximum || s[0].maximum != (float)(s[0].count - 1));
+        }
+    } while (s[0].count < NUM);
+    producer.join();
+
+    std::printf("Reads:%u\n", reads);
+    EXPECT_EQ(torn, 0U);
+}
+
+TEST(OnlineStatistics, Benchmark)
+{
+    constexpr uint32_t NUM{1000000};
+    Stats stats;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < NUM; ++i) {
+        stats.push({{(float)(i & 0xFF), 101325.0f + (i & 0x0F)}});
+    }
+    auto end  = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / NUM;
+    std::printf("push:%.2f ns/sample (2 fields)\n", ns);
+    EXPECT_EQ(stats.snapshot(Field::Temperature).count, NUM);
+}
@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for ProcessingAdapter
+*/
+#define UNIT_ENV_USING_DATA_PROCESSING
+#include <gtest/gtest.h>
+#include <unit/processing_adapter.hpp>
+#include <deque>
+#include <cmath>
+
+using namespace m5::unit;
+
+namespace {
+enum class Field : uint8_t { Temperature, Humidity };
+
+struct Data : processing::Sample<Field, 2> {
+    float t{}, h{};
+    inline std::array<float, 2> values() const
+    {
+        return {{t, h}};
+    }
+};
+
+// Same interface as PeriodicMeasurementAdapter used by the adapter
+class FakeUnit : public ProcessingAdapter<FakeUnit, Data, Field, 2> {
+public:
+    void measure(const float t, const float h, const uint32_t at, const bool valid = true)
+    {
+        Data d{};
+        d.t = t;
+        d.h = h;
+        preprocess(d, at, valid);
+        _data.push_back(d);
+        postprocess(d, valid);
+        _updated = true;
+    }
+    void clear()
+    {
+        _data.clear();
+        _updated = false;
+    }
+
+    inline bool updated() const
+    {
+        return _updated;
+    }
+    inline bool empty() const
+    {
+        return _data.empty();
+    }
+    inline Data latest() const
+    {
+        return !_data.empty() ? _data.back() : Data{};
+    }
+    inline Data oldest() const
+    {
+        return !_data.empty() ? _data.front() : Data{};
+    }
+    inline void discard()
+    {
+        _data.pop_front();
+    }
+    inline size_t available() const
+    {
+        return _data.size();
+    }
+
+private:
+    std::deque<Data> _data{};
+    bool _updated{};
+};
+}  // namespace
+
+TEST(ProcessingAdapter, Disabled)
+{
+    FakeUnit u;
+    EXPECT_FALSE(u.changed());  // Not updated
+
+    u.measure(25.0f, 50.0f, 0);
+    u.measure(25.0f, 50.0f, 1000);
+    EXPECT_TRUE(u.changed());
+    EXPECT_TRUE(u.latest().changed);
+    EXPECT_TRUE(std::isnan(u.latest().filtered_value(Field::Temperature)));
+    EXPECT_EQ(u.statistics().snapshot(Field::Temperature).count, 0U);
+    EXPECT_EQ(u.deadband().samples(), 0U);
+    EXPECT_EQ(u.discardUnchanged(), 0U);
+    EXPECT_EQ(u.available(), 2U);
+}
+
+TEST(ProcessingAdapter, Statistics)
+{
+    FakeUnit u;
+    u.enableStatistics(true, 0.5f);
+    EXPECT_FLOAT_EQ(u.statistics().alpha(), 0.5f);
+
+    u.measure(20.0f, 40.0f, 0);
+    u.measure(30.0f, 60.0f, 1000);
+    u.measure(99.0f, 99.0f, 2000, false);  // Not counted
+    auto s = u.statistics().snapshot(Field::Temperature);
+    EXPECT_EQ(s.count, 2U);
+    EXPECT_FLOAT_EQ(s.mean, 25.0f);
+    EXPECT_FLOAT_EQ(s.maximum, 30.0f);
+    EXPECT_FLOAT_EQ(u.statistics().snapshot(Field::Humidity).mean, 50.0f);
+
+    u.resetStatistics();
+    EXPECT_EQ(u.statistics().snapshot(Field::Temperature).count, 0U);
+    u.enableStatistics(false);
+    u.measure(20.0f, 40.0f, 3000);
+    EXPECT_EQ(u.statistics().snapshot(Field::Temperature).count, 0U);
+}
+
+TEST(ProcessingAdapter, Deadband)
+{
+    FakeUnit u;
+    FakeUnit::deadband_t::config_t cfg{};
+    cfg[Field::Temperature] = 0.5f;
+    cfg[Field::Humidity]    = 2.0f;
+    u.deadband(cfg);
+    u.enableDeadband();
+
+    u.measure(25.0f, 50.0f, 0);  // First
+    EXPECT_TRUE(u.changed());
+    u.measure(25.1f, 50.5f, 1000);
+    EXPECT_FALSE(u.changed());
+    u.measure(25.6f, 50.0f, 2000);
+    EXPECT_TRUE(u.changed());
+    u.measure(40.0f, 90.0f, 3000, false);  // Not representative, never changed
+    EXPECT_FALSE(u.changed());
+    u.measure(25.7f, 50.0f, 4000);
+    EXPECT_FALSE(u.changed());
+
+    EXPECT_EQ(u.deadband().samples(), 4U);
+    EXPECT_EQ(u.deadband().changes(), 2U);
+
+    // Only the changed remain at the head
+    EXPECT_EQ(u.available(), 5U);
+    EXPECT_EQ(u.discardUnchanged(), 0U);  // The oldest is changed
+    u.discard();
+    EXPECT_EQ(u.discardUnchanged(), 1U);
+    EXPECT_FLOAT_EQ(u.oldest().t, 25.6f);
+    u.discard();
+    EXPECT_EQ(u.discardUnchanged(), 2U);
+    EXPECT_TRUE(u.empty());
+
+    // No data
+    EXPECT_EQ(u.discardUnchanged(), 0U);
+    EXPECT_FALSE(u.changed());
+    u.clear();
+    EXPECT_FALSE(u.changed());
+}
+
+TEST(ProcessingAdapter, Filter)
+{
+    FakeUnit u;
+    u.filterPipeline(Field::Temperature, {{filter::Stage::median(3)}});
+    EXPECT_EQ(u.filterPipeline().config(Field::Temperature)[0].type, filter::Type::Median);
+    u.enableFilterPipeline();
+
+    u.measure(25.0f, 50.0f, 0);
+    u.measure(80.0f, 51.0f, 1000);  // Spike
+    u.measure(25.2f, 52.0f, 2000);
+    auto d = u.latest();
+    EXPECT_FLOAT_EQ(d.t, 25.2f);  // Raw is kept
+    EXPECT_FLOAT_EQ(d.filtered_value(Field::Temperature), 25.2f);
+    EXPECT_FLOAT_EQ(d.filtered_value(Field::Humidity), 52.0f);  // Pass through
+
+    u.measure(90.0f, 53.0f, 3000, false);  // Not filtered
+    EXPECT_TRUE(std::isnan(u.latest().filtered_value(Field::Temperature)));
+    u.measure(25.4f, 54.0f, 4000);
+    EXPECT_FLOAT_EQ(u.latest().filtered_value(Field::Temperature), 25.4f);  // Median of 80, 25.2, 25.4
+
+    u.enableFilterPipeline(false);
+    u.measure(25.0f, 50.0f, 5000);
+    EXPECT_TRUE(std::isnan(u.latest().filtered_value(Field::Temperature)));
+}
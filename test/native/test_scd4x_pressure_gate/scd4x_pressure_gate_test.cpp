@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for the ambient pressure compensation rules of SCD4x
+*/
+#include <gtest/gtest.h>
+#include <unit/scd4x_pressure_gate.hpp>
+#include <limits>
+
+using namespace m5::unit::scd4x;
+
+namespace {
+constexpr uint32_t INTERVAL{60 * 1000U};
+constexpr uint32_t START{123456};
+
+// Check and write successfully if due
+bool feed(PressureGate& g, const float hPa, const uint32_t at)
+{
+    uint16_t p{};
+    if (!g.check(hPa, at, p)) {
+        return false;
+    }
+    g.commit(true, p, at);
+    return true;
+}
+}  // namespace
+
+TEST(SCD4xPressureGate, Range)
+{
+    PressureGate g{};
+    uint16_t p{};
+    EXPECT_FALSE(g.check(std::numeric_limits<float>::quiet_NaN(), START, p));
+    EXPECT_FALSE(g.check(std::numeric_limits<float>::infinity(), START, p));
+    EXPECT_FALSE(g.check(699.9f, START, p));
+    EXPECT_FALSE(g.check(1200.1f, START, p));
+    EXPECT_EQ(g.counter().out_of_range, 4U);
+    EXPECT_EQ(g.counter().suppressed(), 4U);
+    EXPECT_EQ(g.lastWritten(), 0U);
+
+    EXPECT_TRUE(g.check(700.0f, START, p));
+    EXPECT_EQ(p, 700U);
+    EXPECT_TRUE(g.check(1200.0f, START, p));
+    EXPECT_EQ(p, 1200U);
+    EXPECT_TRUE(g.check(1013.5f, START, p));
+    EXPECT_EQ(p, 1014U);  // Rounded
+}
+
+TEST(SCD4xPressureGate, Hysteresis)
+{
+    PressureGate g{};
+    EXPECT_TRUE(feed(g, 1013.0f, START));  // The first one is always written
+    EXPECT_EQ(g.lastWritten(), 1013U);
+
+    const uint32_t later = START + INTERVAL;
+    EXPECT_FALSE(feed(g, 1014.4f, later));  // 1 hPa
+    EXPECT_FALSE(feed(g, 1011.6f, later));
+    EXPECT_EQ(g.counter().hysteresis, 2U);
+    EXPECT_TRUE(feed(g, 1015.0f, later));  // Exactly at the hysteresis
+    EXPECT_EQ(g.lastWritten(), 1015U);
+    EXPECT_TRUE(feed(g, 1013.0f, later + INTERVAL));  // Also downward
+    EXPECT_EQ(g.counter().written, 3U);
+    EXPECT_EQ(g.counter().rate_limited, 0U);
+}
+
+TEST(SCD4xPressureGate, Interval)
+{
+    PressureGate g{};
+    EXPECT_TRUE(feed(g, 1000.0f, START));
+    EXPECT_FALSE(feed(g, 1010.0f, START + INTERVAL - 1));  // Just before
+    EXPECT_EQ(g.counter().rate_limited, 1U);
+    EXPECT_TRUE(feed(g, 1010.0f, START + INTERVAL));  // Just at
+    EXPECT_FALSE(feed(g, 1020.0f, START + INTERVAL + 1));
+    EXPECT_TRUE(feed(g, 1020.0f, START + INTERVAL * 2 + 1));  // Just after
+    EXPECT_EQ(g.counter().written, 3U);
+    EXPECT_EQ(g.counter().rate_limited, 2U);
+
+    // Wrap around of the time
+    PressureGate w{};
+    EXPECT_TRUE(feed(w, 1000.0f, 0xFFFFFFFFU - 1000));
+    EXPECT_FALSE(feed(w, 1010.0f, 1000));
+    EXPECT_TRUE(feed(w, 1010.0f, INTERVAL));
+
+    // Hysteresis is checked first
+    PressureGate h{};
+    EXPECT_TRUE(feed(h, 1000.0f, START));
+    EXPECT_FALSE(feed(h, 1001.0f, START + 1));
+    EXPECT_EQ(h.counter().hysteresis, 1U);
+    EXPECT_EQ(h.counter().rate_limited, 0U);
+
+    // No rate limit if zero
+    PressureGate::config_t cfg{};
+    cfg.interval = 0;
+    PressureGate z{cfg};
+    EXPECT_TRUE(feed(z, 1000.0f, START));
+    EXPECT_TRUE(feed(z, 1002.0f, START));
+}
+
+TEST(SCD4xPressureGate, Failed)
+{
+    PressureGate g{};
+    uint16_t p{};
+    EXPECT_TRUE(g.check(1013.0f, START, p));
+    g.commit(false, p, START);
+    EXPECT_EQ(g.counter().failed, 1U);
+    EXPECT_EQ(g.counter().written, 0U);
+    EXPECT_EQ(g.lastWritten(), 0U);
+
+    // Tried again at once since nothing was written
+    EXPECT_TRUE(g.check(1013.0f, START + 1, p));
+    g.commit(true, p, START + 1);
+    EXPECT_EQ(g.lastWritten(), 1013U);
+
+    // A failure after a write keeps the last written value and time
+    EXPECT_TRUE(g.check(1020.0f, START + 1 + INTERVAL, p));
+    g.commit(false, p, START + 1 + INTERVAL);
+    EXPECT_EQ(g.lastWritten(), 1013U);
+    EXPECT_TRUE(feed(g, 1020.0f, START + 2 + INTERVAL));
+    EXPECT_EQ(g.counter().failed, 2U);
+    EXPECT_EQ(g.counter().written, 2U);
+
+    g.reset();
+    EXPECT_EQ(g.counter().failed, 0U);
+    EXPECT_EQ(g.lastWritten(), 0U);
+    EXPECT_TRUE(feed(g, 1020.0f, START + 3 + INTERVAL));  // Forced after reset
+}
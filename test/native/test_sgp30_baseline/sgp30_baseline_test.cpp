@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for the persisted IAQ baseline of SGP30
+*/
+#include <gtest/gtest.h>
+#include <unit/sgp30_baseline_record.hpp>
+#include <cstring>
+
+using namespace m5::unit::sgp30;
+
+namespace {
+constexpr uint32_t HOUR_MS{60 * 60 * 1000U};
+constexpr uint32_t LEARNING{12 * HOUR_MS};
+constexpr uint32_t INTERVAL{HOUR_MS};
+constexpr uint32_t MAX_AGE{7 * 24 * 60 * 60U};
+constexpr uint32_t NOW{1735689600U};  // 2025-01-01
+}  // namespace
+
+TEST(SGP30Baseline, CRC8)
+{
+    // Sensirion datasheet example
+    const uint8_t beef[] = {0xBE, 0xEF};
+    EXPECT_EQ(detail::crc8(beef, sizeof(beef)), 0x92);
+    // CRC-8/NRSC-5 check value
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(detail::crc8(check, sizeof(check)), 0xF7);
+}
+
+TEST(SGP30Baseline, Codec)
+{
+    BaselineRecord rec{};
+    rec.co2eq    = 0x8A3C;
+    rec.tvoc     = 0x8F21;
+    rec.saved_at = NOW;
+    rec.operated = 0x00123456;
+
+    uint8_t buf[BaselineRecord::SIZE]{};
+    rec.encode(buf);
+    EXPECT_EQ(buf[0], 'S');
+    EXPECT_EQ(buf[1], 'B');
+    EXPECT_EQ(buf[3], 0);
+    EXPECT_EQ(buf[4], 0x3C);  // Little endian
+    EXPECT_EQ(buf[5], 0x8A);
+    EXPECT_EQ(buf[14], 0x12);
+    EXPECT_EQ(buf[15], detail::crc8(buf, 15));
+
+    BaselineRecord dec{};
+    EXPECT_TRUE(dec.decode(buf));
+    EXPECT_EQ(dec.co2eq, rec.co2eq);
+    EXPECT_EQ(dec.tvoc, rec.tvoc);
+    EXPECT_EQ(dec.saved_at, rec.saved_at);
+    EXPECT_EQ(dec.operated, rec.operated);
+
+    // Only 24 bits of the operation time are stored
+    rec.operated = 0x01FFFFFF;
+    rec.encode(buf);
+    EXPECT_TRUE(dec.decode(buf));
+    EXPECT_EQ(dec.operated, 0x00FFFFFFU);
+}
+
+TEST(SGP30Baseline, Corrupted)
+{
+    BaselineRecord rec{};
+    rec.co2eq    = 0x8A3C;
+    rec.tvoc     = 0x8F21;
+    rec.saved_at = NOW;
+    uint8_t good[BaselineRecord::SIZE]{};
+    rec.encode(good);
+
+    // Any single bit flip
+    for (size_t i = 0; i < sizeof(good); ++i) {
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            uint8_t buf[BaselineRecord::SIZE]{};
+            std::memcpy(buf, good, sizeof(buf));
+            buf[i] ^= (1U << bit);
+            BaselineRecord dec{};
+            SCOPED_TRACE(i);
+            EXPECT_FALSE(dec.decode(buf));
+            EXPECT_EQ(dec.co2eq, 0);  // Untouched
+        }
+    }
+
+    // Other version with the valid CRC
+    uint8_t buf[BaselineRecord::SIZE]{};
+    std::memcpy(buf, good, sizeof(buf));
+    buf[2]                        = 2;
+    buf[BaselineRecord::SIZE - 1] = detail::crc8(buf, BaselineRecord::SIZE - 1);
+    BaselineRecord dec{};
+    EXPECT_FALSE(dec.decode(buf));
+
+    // Erased storage
+    std::memset(buf, 0xFF, sizeof(buf));
+    EXPECT_FALSE(dec.decode(buf));
+}
+
+TEST(SGP30Baseline, MaxAge)
+{
+    BaselineRecord rec{};
+    rec.saved_at = NOW;
+
+    EXPECT_EQ(age_of(rec, NOW, MAX_AGE), Age::Fresh);
+    EXPECT_EQ(age_of(rec, NOW + MAX_AGE, MAX_AGE), Age::Fresh);
+    EXPECT_EQ(age_of(rec, NOW + MAX_AGE + 1, MAX_AGE), Age::Stale);
+    EXPECT_EQ(age_of(rec, NOW + 30 * 24 * 60 * 60U, MAX_AGE), Age::Stale);
+
+    // Clock not set now or on the save, or saved in the future
+    EXPECT_EQ(age_of(rec, 0, MAX_AGE), Age::Unknown);
+    EXPECT_EQ(age_of(rec, NOW - 1, MAX_AGE), Age::Unknown);
+    rec.saved_at = 0;
+    EXPECT_EQ(age_of(rec, NOW, MAX_AGE), Age::Unknown);
+}
+
+TEST(SGP30Baseline, LearningWindow)
+{
+    // Not restored: nothing within the learning period, the first snapshot right after it
+    EXPECT_FALSE(snapshot_due(false, 0, 0, 0, LEARNING, INTERVAL));
+    EXPECT_FALSE(snapshot_due(false, 0, INTERVAL, INTERVAL, LEARNING, INTERVAL));
+    EXPECT_FALSE(snapshot_due(false, 0, LEARNING - 1, LEARNING - 1, LEARNING, INTERVAL));
+    EXPECT_TRUE(snapshot_due(false, 0, LEARNING, 0, LEARNING, INTERVAL));
+    // Then every interval
+    EXPECT_FALSE(snapshot_due(false, 1, LEARNING + 1000, 1000, LEARNING, INTERVAL));
+    EXPECT_TRUE(snapshot_due(false, 1, LEARNING + INTERVAL, INTERVAL, LEARNING, INTERVAL));
+
+    // Restored: no learning period, every interval
+    EXPECT_FALSE(snapshot_due(true, 0, 0, 0, LEARNING, INTERVAL));
+    EXPECT_FALSE(snapshot_due(true, 0, INTERVAL - 1, INTERVAL - 1, LEARNING, INTERVAL));
+    EXPECT_TRUE(snapshot_due(true, 0, INTERVAL, INTERVAL, LEARNING, INTERVAL));
+    EXPECT_TRUE(snapshot_due(true, 5, 6 * INTERVAL, INTERVAL, LEARNING, INTERVAL));
+
+    // Simulated run of a day without a restored baseline (1 minute tick)
+    uint32_t saved{}, first{}, snapshot_at{};
+    for (uint32_t at = 0; at <= 24 * HOUR_MS; at += 60 * 1000U) {
+        if (snapshot_due(false, saved, at, at - snapshot_at, LEARNING, INTERVAL)) {
+            snapshot_at = at;
+            first       = saved++ ? first : at;
+        }
+    }
+    EXPECT_EQ(first, LEARNING);
+    EXPECT_EQ(saved, 13U);  // 12h, 13h ... 24h
+}
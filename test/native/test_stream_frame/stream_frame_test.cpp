@@ -0,0 +1,268 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest and benchmark for binary stream frames
+*/
+#include <gtest/gtest.h>
+#include <unit/stream_frame.hpp>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+
+using namespace m5::unit::stream;
+
+namespace {
+constexpr uint32_t BAUD{115200};
+constexpr uint32_t BYTES_PER_SEC{BAUD / 10};  // 8N1
+
+// SHT30 raw data without CRC
+std::vector<uint8_t> sht30_payload(const float celsius, const float rh)
+{
+    uint16_t t = (uint16_t)((celsius + 45) * 65535 / 175.0f + 0.5f);
+    uint16_t h = (uint16_t)(rh * 65536 / 100.0f + 0.5f);
+    return {(uint8_t)(t >> 8), (uint8_t)t, (uint8_t)(h >> 8), (uint8_t)h};
+}
+
+std::vector<uint8_t> bme688_payload(const float t, const float p, const float h, const float g, const uint8_t idx)
+{
+    std::vector<uint8_t> v(20);
+    const float f[4] = {t, p, h, g};
+    std::memcpy(v.data(), f, sizeof(f));
+    v[16] = idx;
+    v[17] = idx;
+    v[18] = 0xB0;
+    v[19] = 0;
+    return v;
+}
+
+void append(std::vector<uint8_t>& out, Encoder& enc, const Type type, const uint8_t id, const uint32_t ts,
+            const std::vector<uint8_t>& payload)
+{
+    uint8_t buf[TIME_FRAME_LENGTH + MAX_FRAME_LENGTH];
+    size_t len = enc.encode(buf, sizeof(buf), type, id, ts, payload.data(), payload.size());
+    ASSERT_NE(len, 0U);
+    out.insert(out.end(), buf, buf + len);
+}
+}  // namespace
+
+TEST(StreamFrame, RoundTrip)
+{
+    Encoder enc;
+    std::vector<uint8_t> bytes;
+    append(bytes, enc, Type::SHT30, 1, 1000, sht30_payload(25.0f, 50.0f));
+    append(bytes, enc, Type::BME688, 2, 1100, bme688_payload(24.5f, 101325.0f, 40.0f, 12345.0f, 3));
+    append(bytes, enc, Type::SHT30, 1, 1200, sht30_payload(-10.0f, 90.0f));
+
+    // SYNC + Time + SHT30 frame
+    EXPECT_EQ(bytes[0], SYNC);
+    EXPECT_EQ(bytes[1], (uint8_t)Type::Time);
+    EXPECT_EQ(bytes.size(), TIME_FRAME_LENGTH + (HEADER_LENGTH + 4 + 1) * 2 + (HEADER_LENGTH + 20 + 1));
+
+    Decoder dec;
+    std::vector<Sample> v;
+    EXPECT_EQ(dec.decode(bytes.data(), bytes.size(), [&v](const Sample& s) { v.push_back(s); }), 3U);
+    ASSERT_EQ(v.size(), 3U);
+
+    EXPECT_EQ(v[0].type, Type::SHT30);
+    EXPECT_EQ(v[0].id, 1U);
+    EXPECT_EQ(v[0].timestamp, 1000U);
+    EXPECT_NEAR(v[0].temperature(), 25.0f, 0.01f);
+    EXPECT_NEAR(v[0].humidity(), 50.0f, 0.01f);
+    EXPECT_TRUE(std::isnan(v[0].pressure()));
+
+    EXPECT_EQ(v[1].type, Type::BME688);
+    EXPECT_EQ(v[1].id, 2U);
+    EXPECT_EQ(v[1].timestamp, 1100U);
+    EXPECT_FLOAT_EQ(v[1].temperature(), 24.5f);
+    EXPECT_FLOAT_EQ(v[1].pressure(), 101325.0f);
+    EXPECT_FLOAT_EQ(v[1].humidity(), 40.0f);
+    EXPECT_FLOAT_EQ(v[1].gas(), 12345.0f);
+    EXPECT_EQ(v[1].payload[16], 3U);
+
+    EXPECT_EQ(v[2].timestamp, 1200U);
+    EXPECT_NEAR(v[2].temperature(), -10.0f, 0.01f);
+    EXPECT_NEAR(v[2].humidity(), 90.0f, 0.01f);
+
+    EXPECT_EQ(dec.frames(), 4U);
+    EXPECT_EQ(dec.errors(), 0U);
+    EXPECT_EQ(dec.dropped(), 0U);
+    EXPECT_EQ(dec.unsynced(), 0U);
+}
+
+TEST(StreamFrame, Timestamp)
+{
+    Encoder enc;
+    std::vector<uint8_t> bytes;
+    append(bytes, enc, Type::SGP30, 0, 0xFFFFFF00U, {0x01, 0x90, 0x00, 0x10});
+    const size_t first = bytes.size();
+    append(bytes, enc, Type::SGP30, 0, 0xFFFFFF00U + 0xFFFF, {0x01, 0x91, 0x00, 0x11});
+    EXPECT_EQ(bytes.size() - first, HEADER_LENGTH + 4 + 1U);  // Delta fits
+    // Over 16 bits and wrap around
+    append(bytes, enc, Type::SGP30, 0, 0x00020000U, {0x01, 0x92, 0x00, 0x12});
+
+    Decoder dec;
+    std::vector<Sample> v;
+    dec.decode(bytes.data(), bytes.size(), [&v](const Sample& s) { v.push_back(s); });
+    ASSERT_EQ(v.size(), 3U);
+    EXPECT_EQ(v[0].timestamp, 0xFFFFFF00U);
+    EXPECT_EQ(v[1].timestamp, 0xFFFFFF00U + 0xFFFF);
+    EXPECT_EQ(v[2].timestamp, 0x00020000U);
+    EXPECT_EQ(v[0].co2(), 400U);
+    EXPECT_EQ(v[2].tvoc(), 0x12U);
+
+    // Decoder started in the middle of the stream
+    Decoder late;
+    const size_t skip = TIME_FRAME_LENGTH;
+    EXPECT_EQ(late.decode(bytes.data() + skip, bytes.size() - skip, [](const Sample&) {}), 3U);
+    EXPECT_EQ(late.unsynced(), 2U);
+}
+
+TEST(StreamFrame, Resync)
+{
+    Encoder enc;
+    std::vector<uint8_t> bytes{0x00, SYNC, 0x12, SYNC};  // Garbage including SYNC
+    std::vector<size_t> offsets;
+    for (uint32_t i = 0; i < 10; ++i) {
+        offsets.push_back(bytes.size());
+        append(bytes, enc, Type::SHT30, 0, i * 100, sht30_payload(20.0f + i, 50.0f));
+    }
+
+    // Broken payload of the 4th frame
+    bytes[offsets[3] + HEADER_LENGTH + 1] ^= 0x5A;
+    // Cut the 7th frame
+    bytes.erase(bytes.begin() + offsets[6] + 3, bytes.begin() + offsets[7]);
+
+    Decoder dec;
+    std::vector<Sample> v;
+    // Fed in small chunks
+    for (size_t i = 0; i < bytes.size(); i += 3) {
+        dec.decode(bytes.data() + i, std::min<size_t>(3, bytes.size() - i), [&v](const Sample& s) { v.push_back(s); });
+    }
+    ASSERT_EQ(v.size(), 8U);
+    EXPECT_GE(dec.errors(), 1U);
+    EXPECT_GT(dec.dropped(), 0U);
+
+    std::vector<uint32_t> expected{0, 100, 200, 400, 500, 700, 800, 900};
+    for (size_t i = 0; i < v.size(); ++i) {
+        EXPECT_EQ(v[i].timestamp, expected[i]) << i;
+        EXPECT_NEAR(v[i].temperature(), 20.0f + expected[i] / 100, 0.01f) << i;
+    }
+
+    // Broken length of the 2nd frame swallows the following frames, they must be recovered
+    bytes.clear();
+    offsets.clear();
+    for (uint32_t i = 0; i < 4; ++i) {
+        append(bytes, enc, Type::SHT30, 0, 1000 + i * 100, sht30_payload(20.0f + i, 50.0f));
+        offsets.push_back(bytes.size() - (HEADER_LENGTH + 4 + 1));  // Data frame after the time frame if any
+    }
+    Decoder intact;
+    EXPECT_EQ(intact.decode(bytes.data(), bytes.size(), [](const Sample&) {}), 4U);
+    bytes[offsets[1] + 5] = 20;
+
+    for (size_t chunk : {bytes.size(), (size_t)3, (size_t)1}) {
+        Decoder d;
+        v.clear();
+        for (size_t i = 0; i < bytes.size(); i += chunk) {
+            d.decode(bytes.data() + i, std::min(chunk, bytes.size() - i), [&v](const Sample& s) { v.push_back(s); });
+        }
+        SCOPED_TRACE(chunk);
+        ASSERT_EQ(v.size(), 3U);
+        EXPECT_EQ(d.errors(), 1U);
+        EXPECT_EQ(d.frames(), intact.frames() - 1);  // Only the broken one is lost
+        EXPECT_EQ(v[0].timestamp, 1000U);
+        EXPECT_EQ(v[1].timestamp, 1200U);
+        EXPECT_EQ(v[2].timestamp, 1300U);
+    }
+
+    // Byte by byte with push(), the recovered frames are reported on the following pushes
+    {
+        Decoder d;
+        std::vector<uint32_t> ts;
+        for (auto b : bytes) {
+            if (d.push(b)) {
+                ts.push_back(d.sample().timestamp);
+            }
+        }
+        for (uint8_t i = 0; i < MAX_FRAME_LENGTH; ++i) {
+            if (d.push(0x00)) {  // Padding
+                ts.push_back(d.sample().timestamp);
+            }
+        }
+        EXPECT_EQ(ts, (std::vector<uint32_t>{1000, 1200, 1300}));
+    }
+}
+
+TEST(StreamFrame, Invalid)
+{
+    Encoder enc;
+    uint8_t buf[TIME_FRAME_LENGTH + MAX_FRAME_LENGTH]{};
+    uint8_t payload[MAX_PAYLOAD + 1]{};
+    EXPECT_EQ(enc.encode(buf, sizeof(buf), Type::SHT30, 0, 0, payload, MAX_PAYLOAD + 1), 0U);
+    EXPECT_EQ(enc.encode(buf, sizeof(buf), Type::SHT30, 0, 0, nullptr, 4), 0U);
+    EXPECT_EQ(enc.encode(buf, TIME_FRAME_LENGTH + HEADER_LENGTH + 4, Type::SHT30, 0, 0, payload, 4), 0U);
+    // Fail does not consume the time sync
+    EXPECT_EQ(enc.encode(buf, sizeof(buf), Type::SHT30, 0, 0, payload, 4), TIME_FRAME_LENGTH + HEADER_LENGTH + 4 + 1U);
+}
+
+TEST(StreamFrame, Benchmark)
+{
+    // 10 mps SHT30 and BME688 parallel mode (3 fields per about 150ms) from 8 units
+    constexpr uint32_t UNITS{8};
+    constexpr uint32_t SECONDS{60};
+    Encoder enc;
+    std::vector<uint8_t> bytes;
+    bytes.reserve(1024 * 1024);
+    uint32_t samples{};
+    uint8_t buf[TIME_FRAME_LENGTH + MAX_FRAME_LENGTH];
+
+    auto sht  = sht30_payload(25.0f, 50.0f);
+    auto bme  = bme688_payload(24.5f, 101325.0f, 40.0f, 12345.0f, 3);
+    auto bstart = std::chrono::steady_clock::now();
+    for (uint32_t ms = 0; ms < SECONDS * 1000; ms += 50) {
+        for (uint8_t u = 0; u < UNITS; ++u) {
+            if (ms % 100 == 0) {
+                size_t len = enc.encode(buf, sizeof(buf), Type::SHT30, u, ms, sht.data(), sht.size());
+                bytes.insert(bytes.end(), buf, buf + len);
+                ++samples;
+            }
+            if (ms % 150 == 0) {
+                for (uint8_t f = 0; f < 3; ++f) {
+                    size_t len = enc.encode(buf, sizeof(buf), Type::BME688, u + UNITS, ms, bme.data(), bme.size());
+                    bytes.insert(bytes.end(), buf, buf + len);
+                    ++samples;
+                }
+            }
+        }
+    }
+    auto bend     = std::chrono::steady_clock::now();
+    double enc_ns = std::chrono::duration<double, std::nano>(bend - bstart).count() / samples;
+
+    Decoder dec;
+    uint32_t decoded{};
+    float sink{};
+    bstart = std::chrono::steady_clock::now();
+    decoded += dec.decode(bytes.data(), bytes.size(), [&sink](const Sample& s) { sink += s.temperature(); });
+    bend          = std::chrono::steady_clock::now();
+    double dec_ns = std::chrono::duration<double, std::nano>(bend - bstart).count() / samples;
+    EXPECT_EQ(decoded, samples);
+    EXPECT_EQ(dec.errors(), 0U);
+
+    // Text by printf as the PlotToSerial examples
+    char text[64];
+    size_t text_bytes{};
+    text_bytes += std::snprintf(text, sizeof(text), "%u,%.2f,%.2f\n", 0U, 25.0f, 50.0f) * (samples / 4);
+    text_bytes += std::snprintf(text, sizeof(text), "%u,%.2f,%.2f,%.2f,%.2f\n", 8U, 24.5f, 101325.0f, 40.0f, 12345.0f) *
+                  (samples - samples / 4);
+
+    double rate      = (double)bytes.size() / SECONDS;
+    double text_rate = (double)text_bytes / SECONDS;
+    std::printf("%u samples/s: binary %.0f B/s (%.1f%% of %u baud) text %.0f B/s (%.1f%%)\n", samples / SECONDS, rate,
+                rate * 100 / BYTES_PER_SEC, BAUD, text_rate, text_rate * 100 / BYTES_PER_SEC);
+    std::printf("Max samples/s at %u baud: SHT30 %u BME688 %u\n", BAUD, BYTES_PER_SEC / (HEADER_LENGTH + 4 + 1),
+                BYTES_PER_SEC / (HEADER_LENGTH + 20 + 1));
+    std::printf("Encode %.2f ns/sample Decode %.2f ns/sample (%f)\n", enc_ns, dec_ns, sink);
+    EXPECT_LT(rate, BYTES_PER_SEC);
+}
@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2024 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest and benchmark for text formatter
+*/
+#include <gtest/gtest.h>
+#include <unit/text_formatter.hpp>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+using namespace m5::unit::text;
+
+namespace {
+struct Dummy {
+    float t{}, h{};
+    uint16_t c{};
+    float temperature() const
+    {
+        return t;
+    }
+    float humidity() const
+    {
+        return h;
+    }
+    uint16_t co2() const
+    {
+        return c;
+    }
+};
+
+template <typename F>
+double bench(F func, const std::vector<Dummy>& data, size_t& sink)
+{
+    constexpr uint32_t LOOP{100};
+    char buf[128];
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < LOOP; ++n) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            sink += func(buf, sizeof(buf), data[i], i);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (LOOP * data.size());
+}
+}  // namespace
+
+TEST(TextFormatter, Fixed)
+{
+    char buf[64];
+    Formatter f(buf, sizeof(buf));
+
+    f.fixed(25.125f, 2);
+    EXPECT_STREQ(f.c_str(), "25.13");
+    f.clear();
+    f.fixed(-3.14159f, 3);
+    EXPECT_STREQ(f.c_str(), "-3.142");
+    f.clear();
+    f.fixed(0.05f, 1);
+    EXPECT_STREQ(f.c_str(), "0.1");
+    f.clear();
+    f.fixed(-0.001f, 2);  // No negative zero
+    EXPECT_STREQ(f.c_str(), "0.00");
+    f.clear();
+    f.fixed(101325.0f, 0);
+    EXPECT_STREQ(f.c_str(), "101325");
+    f.clear();
+    f.fixed(1.5f, 9);  // Clamped to MAX_DECIMALS
+    EXPECT_STREQ(f.c_str(), "1.500000");
+    f.clear();
+    EXPECT_FALSE(f.fixed(std::numeric_limits<float>::quiet_NaN(), 2));
+    EXPECT_FALSE(f.fixed(std::numeric_limits<float>::infinity(), 2));
+    EXPECT_FALSE(f.fixed(1e30f, 2));
+    EXPECT_EQ(f.length(), 0U);
+    f.integer(-42).character(' ').uint(18446744073709551615ULL);
+    EXPECT_STREQ(f.c_str(), "-42 18446744073709551615");
+    EXPECT_TRUE(f.ok());
+}
+
+TEST(TextFormatter, CompareSnprintf)
+{
+    char buf[32], ref[32];
+    uint32_t seed{12345}, mismatch{}, count{};
+    for (int i = 0; i < 100000; ++i) {
+        seed = seed * 1103515245U + 12345U;
+        // Alternately the range of the measured values and the small values with all the decimals
+        const float v = (i & 1) ? -50000.0f + 150000.0f * ((seed >> 8) & 0xFFFF) / 65535.0f
+                                : -8.0f + 16.0f * (seed >> 8) / 16777215.0f;
+        for (uint8_t dec = 0; dec <= MAX_DECIMALS; ++dec) {
+            Formatter f(buf, sizeof(buf));
+            ASSERT_TRUE(f.fixed(v, dec));
+            std::snprintf(ref, sizeof(ref), "%.*f", dec, v);
+            ++count;
+            if (ref[0] == '-' && !std::strcmp(buf, ref + 1) && !std::strpbrk(buf, "123456789")) {
+                continue;  // No negative zero
+            }
+            if (std::strcmp(buf, ref)) {
+                // Only on the exact halfway, rounded half away from zero (snprintf rounds half to even)
+                ++mismatch;
+                const double scaled = std::fabs((double)v) * std::pow(10.0, dec);
+                EXPECT_EQ(scaled - std::floor(scaled), 0.5) << buf << " " << ref;
+            }
+        }
+    }
+    std::printf("Mismatch on halfway:%u/%u\n", mismatch, count);
+}
+
+TEST(TextFormatter, Overflow)
+{
+    char buf[8];
+    Formatter f(buf, sizeof(buf));
+    f.text("0123456789");
+    EXPECT_FALSE(f.ok());
+    EXPECT_EQ(f.length(), 7U);
+    EXPECT_STREQ(f.c_str(), "0123456");
+
+    Formatter z(nullptr, 0);
+    z.text("a");
+    EXPECT_FALSE(z.ok());
+    EXPECT_EQ(z.length(), 0U);
+}
+
+TEST(TextFormatter, Csv)
+{
+    char buf[128];
+    Formatter f(buf, sizeof(buf));
+    Dummy d{25.126f, 50.5f, 415};
+
+    CsvHeader h(f);
+    h.column("timestamp")
+        .field("co2", d, &Dummy::co2)
+        .field("temperature", d, &Dummy::temperature, 2)
+        .field("humidity", d, &Dummy::humidity, 2)
+        .end();
+    CsvLine l(f);
+    l.column(1000)
+        .field("co2", d, &Dummy::co2)
+        .field("temperature", d, &Dummy::temperature, 2)
+        .field("humidity", std::numeric_limits<float>::quiet_NaN(), 2)
+        .end();
+    EXPECT_STREQ(f.c_str(), "timestamp,co2,temperature,humidity\n1000,415,25.13,\n");
+}
+
+TEST(TextFormatter, Influx)
+{
+    char buf[128];
+    Formatter f(buf, sizeof(buf));
+    Dummy d{-5.0f, 99.999f, 1200};
+
+    InfluxLine l(f, "env");
+    l.tag("unit", "scd4x")
+        .field("co2", d, &Dummy::co2)
+        .field("temperature", std::numeric_limits<float>::quiet_NaN(), 2)  // Skipped
+        .field("temperature", d, &Dummy::temperature, 2)
+        .field("humidity", d, &Dummy::humidity, 2);
+    EXPECT_EQ(l.count(), 3U);
+    l.end(1700000000000000000ULL);
+    EXPECT_STREQ(f.c_str(), "env,unit=scd4x co2=1200i,temperature=-5.00,humidity=100.00 1700000000000000000\n");
+
+    f.clear();
+    InfluxLine n(f, "env");
+    n.field("temperature", std::numeric_limits<float>::quiet_NaN(), 2)
+        .field("humidity", 12.0f, 1)
+        .end();
+    EXPECT_STREQ(f.c_str(), "env humidity=12.0\n");
+}
+
+TEST(TextFormatter, Benchmark)
+{
+    std::vector<Dummy> data;
+    uint32_t seed{12345};
+    for (int i = 0; i < 4096; ++i) {
+        Dummy d;
+        seed = seed * 1103515245U + 12345U;
+        d.t  = -10.0f + 50.0f * ((seed >> 8) & 0xFFFF) / 65535.0f;
+        seed = seed * 1103515245U + 12345U;
+        d.h  = 100.0f * ((seed >> 8) & 0xFFFF) / 65535.0f;
+        d.c  = 400 + (seed >> 20);
+        data.push_back(d);
+    }
+
+    auto by_snprintf = [](char* buf, size_t cap, const Dummy& d, size_t ts) -> size_t {
+        return std::snprintf(buf, cap, "env,unit=scd4x co2=%ui,temperature=%.2f,humidity=%.2f %zu\n", d.c, d.t, d.h,
+                             ts);
+    };
+    auto by_formatter = [](char* buf, size_t cap, const Dummy& d, size_t ts) -> size_t {
+        Formatter f(buf, cap);
+        InfluxLine(f, "env")
+            .tag("unit", "scd4x")
+            .field("co2", d, &Dummy::co2)
+            .field("temperature", d, &Dummy::temperature, 2)
+            .field("humidity", d, &Dummy::humidity, 2)
+            .end(ts);
+        return f.length();
+    };
+
+    size_t sink_s{}, sink_f{};
+    double s  = bench(by_snprintf, data, sink_s);
+    double fm = bench(by_formatter, data, sink_f);
+    std::printf("snprintf:%.2f ns/line Formatter:%.2f ns/line (x%.2f)\n", s, fm, s / fm);
+    // Same length for all lines except the rare halfway rounding
+    EXPECT_NEAR((double)sink_f, (double)sink_s, sink_s * 0.001);
+}